@@ -0,0 +1,116 @@
+// Copyright (c) 2015-2016 The Bitcoin Core developers
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "tinyformat.h"
+
+#include <iostream>
+#include <limits>
+#include <regex>
+
+#include <univalue.h>
+
+benchmark::BenchRunner::BenchmarkMap& benchmark::BenchRunner::benchmarks()
+{
+    static std::map<std::string, benchmark::BenchFunction> benchmarks_map;
+    return benchmarks_map;
+}
+
+benchmark::BenchRunner::BenchRunner(std::string name, benchmark::BenchFunction func)
+{
+    benchmarks().insert(std::make_pair(name, func));
+}
+
+std::vector<std::string> benchmark::BenchRunner::List()
+{
+    std::vector<std::string> vNames;
+    for (const auto& it : benchmarks())
+        vNames.push_back(it.first);
+    return vNames;
+}
+
+bool benchmark::BenchRunner::RunAll(const Options& options)
+{
+    std::regex reFilter(options.strFilter);
+    bool fJSON = options.strPrinter == "json";
+    bool fCSV = options.strPrinter == "csv";
+    if (!fJSON && !fCSV && options.strPrinter != "console") {
+        std::cerr << "Unknown printer " << options.strPrinter << std::endl;
+        return false;
+    }
+
+    if (fCSV)
+        std::cout << "name,iterations,total,min,max,average" << std::endl;
+    else if (!fJSON)
+        std::cout << "#Benchmark" << "," << "count" << "," << "min" << "," << "max" << "," << "average" << std::endl;
+
+    UniValue results(UniValue::VARR);
+    for (const auto& it : benchmarks()) {
+        if (!std::regex_match(it.first, reFilter))
+            continue;
+
+        State state(it.first, options.nWarmup, options.nMaxIterations, options.maxElapsed);
+        it.second(state);
+        const Result& result = state.GetResult();
+
+        if (fJSON) {
+            UniValue obj(UniValue::VOBJ);
+            obj.push_back(Pair("name", result.name));
+            obj.push_back(Pair("iterations", result.nIterations));
+            obj.push_back(Pair("total", result.total));
+            obj.push_back(Pair("min", result.min));
+            obj.push_back(Pair("max", result.max));
+            obj.push_back(Pair("average", result.Average()));
+            results.push_back(obj);
+        } else if (fCSV) {
+            std::cout << strprintf("%s,%d,%.9f,%.9f,%.9f,%.9f", result.name, result.nIterations, result.total, result.min, result.max, result.Average()) << std::endl;
+        } else {
+            std::cout << strprintf("%s,%d,%g,%g,%g", result.name, result.nIterations, result.min, result.max, result.Average()) << std::endl;
+        }
+    }
+
+    if (fJSON)
+        std::cout << results.write(2) << std::endl;
+    return true;
+}
+
+benchmark::State::State(const std::string& _name, uint64_t _nWarmup, uint64_t _nMaxIterations, double _maxElapsed)
+    : name(_name), nWarmup(_nWarmup), nMaxIterations(_nMaxIterations), maxElapsed(_maxElapsed), fStarted(false)
+{
+    result.name = name;
+    result.nIterations = 0;
+    result.total = 0;
+    result.min = std::numeric_limits<double>::max();
+    result.max = 0;
+}
+
+bool benchmark::State::KeepRunning()
+{
+    clock::time_point now = clock::now();
+    if (fStarted) {
+        // Time the iteration that just finished, unless it was a warmup one
+        if (nWarmup > 0) {
+            --nWarmup;
+        } else {
+            double elapsed = std::chrono::duration<double>(now - lastTime).count();
+            ++result.nIterations;
+            result.total += elapsed;
+            result.min = std::min(result.min, elapsed);
+            result.max = std::max(result.max, elapsed);
+        }
+    }
+    fStarted = true;
+
+    if (result.nIterations > 0 && (result.nIterations >= nMaxIterations || result.total >= maxElapsed)) {
+        if (result.min == std::numeric_limits<double>::max())
+            result.min = 0;
+        return false;
+    }
+
+    // Leave the clock read last, so the bookkeeping above is not timed
+    lastTime = clock::now();
+    return true;
+}
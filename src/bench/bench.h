@@ -0,0 +1,103 @@
+// Copyright (c) 2015-2016 The Bitcoin Core developers
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef nativecoin_BENCH_BENCH_H
+#define nativecoin_BENCH_BENCH_H
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <boost/preprocessor/cat.hpp>
+#include <boost/preprocessor/stringize.hpp>
+
+// Simple micro-benchmarking framework; API mostly matches a subset of the Google Benchmark
+// framework (see https://github.com/google/benchmark)
+// Why not use the Google Benchmark framework? Because adding Yet Another Dependency
+// (that uses cmake as its build system and has lots of features we don't need) isn't
+// worth it.
+
+/*
+ * Usage:
+
+static void CODE_TO_TIME(benchmark::State& state)
+{
+    ... do any setup needed...
+    while (state.KeepRunning()) {
+       ... do stuff you want to time...
+    }
+    ... do any cleanup needed...
+}
+
+BENCHMARK(CODE_TO_TIME);
+
+ */
+
+namespace benchmark
+{
+typedef std::chrono::high_resolution_clock clock;
+
+//! Timings of one benchmark, in seconds per iteration
+struct Result {
+    std::string name;
+    uint64_t nIterations;
+    double total;
+    double min;
+    double max;
+
+    double Average() const { return nIterations ? total / nIterations : 0; }
+};
+
+class State
+{
+    std::string name;
+    //! Iterations run before the measured ones, to fill caches and lazily built tables
+    uint64_t nWarmup;
+    //! Stop after this many measured iterations
+    uint64_t nMaxIterations;
+    //! Stop once the measured iterations took this long, after at least one
+    double maxElapsed;
+
+    bool fStarted;
+    clock::time_point lastTime;
+    Result result;
+
+public:
+    State(const std::string& _name, uint64_t _nWarmup, uint64_t _nMaxIterations, double _maxElapsed);
+    bool KeepRunning();
+    const Result& GetResult() const { return result; }
+};
+
+typedef std::function<void(State&)> BenchFunction;
+
+class BenchRunner
+{
+    typedef std::map<std::string, BenchFunction> BenchmarkMap;
+    static BenchmarkMap& benchmarks();
+
+public:
+    struct Options {
+        std::string strFilter;
+        std::string strPrinter;
+        uint64_t nWarmup;
+        uint64_t nMaxIterations;
+        double maxElapsed;
+    };
+
+    BenchRunner(std::string name, BenchFunction func);
+
+    static std::vector<std::string> List();
+    static bool RunAll(const Options& options);
+};
+}
+
+// BENCHMARK(foo) expands to:  benchmark::BenchRunner bench_11foo("foo", foo);
+#define BENCHMARK(n) \
+    benchmark::BenchRunner BOOST_PP_CAT(bench_, BOOST_PP_CAT(__LINE__, n))(BOOST_PP_STRINGIZE(n), n);
+
+#endif // nativecoin_BENCH_BENCH_H
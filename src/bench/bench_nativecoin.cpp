@@ -0,0 +1,65 @@
+// Copyright (c) 2015-2016 The Bitcoin Core developers
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chainparams.h"
+#include "crypto/sha256.h"
+#include "key.h"
+#include "util.h"
+
+#include <iostream>
+
+static const char* DEFAULT_BENCH_FILTER = ".*";
+static const char* DEFAULT_BENCH_PRINTER = "console";
+static const int64_t DEFAULT_BENCH_WARMUP = 1;
+static const int64_t DEFAULT_BENCH_ITERATIONS = 1000000000;
+static const int64_t DEFAULT_BENCH_TIME_MILLIS = 1000;
+
+static void PrintUsage()
+{
+    std::cout << "Usage: bench_nativecoin [options]\n\n"
+              << "Options:\n"
+              << "  -?                 Print this help message and exit\n"
+              << "  -list              List the benchmarks and exit\n"
+              << "  -filter=<regex>    Only run the benchmarks whose name matches (default: " << DEFAULT_BENCH_FILTER << ")\n"
+              << "  -printer=<format>  Output format: console, csv or json (default: " << DEFAULT_BENCH_PRINTER << ")\n"
+              << "  -warmup=<n>        Unmeasured iterations run before each benchmark (default: " << DEFAULT_BENCH_WARMUP << ")\n"
+              << "  -iterations=<n>    Max measured iterations of each benchmark (default: " << DEFAULT_BENCH_ITERATIONS << ")\n"
+              << "  -time=<ms>         Stop each benchmark after it ran this long (default: " << DEFAULT_BENCH_TIME_MILLIS << ")\n";
+}
+
+int main(int argc, char** argv)
+{
+    ParseParameters(argc, argv);
+    if (mapArgs.count("-?") || mapArgs.count("-h") || mapArgs.count("-help")) {
+        PrintUsage();
+        return 0;
+    }
+
+    if (mapArgs.count("-list")) {
+        for (const std::string& strName : benchmark::BenchRunner::List())
+            std::cout << strName << std::endl;
+        return 0;
+    }
+
+    SHA256AutoDetect();
+    ECC_Start();
+    SetupEnvironment();
+    fPrintToDebugLog = false; // don't want to write to debug.log file
+    SelectParams(CBaseChainParams::MAIN);
+
+    benchmark::BenchRunner::Options options;
+    options.strFilter = GetArg("-filter", DEFAULT_BENCH_FILTER);
+    options.strPrinter = GetArg("-printer", DEFAULT_BENCH_PRINTER);
+    options.nWarmup = std::max(GetArg("-warmup", DEFAULT_BENCH_WARMUP), (int64_t)0);
+    options.nMaxIterations = std::max(GetArg("-iterations", DEFAULT_BENCH_ITERATIONS), (int64_t)1);
+    options.maxElapsed = std::max(GetArg("-time", DEFAULT_BENCH_TIME_MILLIS), (int64_t)0) * 0.001;
+
+    bool fSuccess = benchmark::BenchRunner::RunAll(options);
+
+    ECC_Stop();
+    return fSuccess ? 0 : 1;
+}
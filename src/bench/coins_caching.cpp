@@ -0,0 +1,82 @@
+// Copyright (c) 2016 The Bitcoin Core developers
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "coins.h"
+#include "key.h"
+#include "main.h"
+#include "random.h"
+#include "script/standard.h"
+
+// Transactions with unspent outputs in the cache
+static const int CACHED_TXS = 10000;
+
+static void CCoinsViewCacheAccessCoins(benchmark::State& state)
+{
+    CCoinsView viewDummy;
+    CCoinsViewCache cache(&viewDummy);
+
+    std::vector<uint256> vTxids;
+    for (int i = 0; i < CACHED_TXS; i++) {
+        uint256 txid = GetRandHash();
+        CCoinsModifier coins = cache.ModifyCoins(txid);
+        coins->nVersion = 1;
+        coins->nHeight = i;
+        coins->vout.resize(2);
+        coins->vout[0].nValue = i;
+        coins->vout[1].nValue = i;
+        vTxids.push_back(txid);
+    }
+
+    // half of the lookups miss the cache and fall through to the (empty) backing view
+    std::vector<uint256> vMissing;
+    for (int i = 0; i < CACHED_TXS; i++)
+        vMissing.push_back(GetRandHash());
+
+    size_t n = 0;
+    while (state.KeepRunning()) {
+        assert(cache.AccessCoins(vTxids[n % vTxids.size()]));
+        assert(!cache.HaveCoins(vMissing[n % vMissing.size()]));
+        n++;
+    }
+}
+
+BENCHMARK(CCoinsViewCacheAccessCoins);
+
+// Standardness check of a transaction whose pay-to-pubkey-hash inputs are in the cache
+static void CCoinsViewCacheAreInputsStandard(benchmark::State& state)
+{
+    CCoinsView viewDummy;
+    CCoinsViewCache cache(&viewDummy);
+
+    CKey key;
+    key.MakeNewKey(true);
+    CScript scriptPubKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+    CMutableTransaction tx;
+    for (int i = 0; i < 10; i++) {
+        uint256 txid = GetRandHash();
+        CCoinsModifier coins = cache.ModifyCoins(txid);
+        coins->nVersion = 1;
+        coins->vout.resize(1);
+        coins->vout[0].nValue = 50 * COIN;
+        coins->vout[0].scriptPubKey = scriptPubKey;
+
+        // the signature is not checked, only the shape of the scriptSig
+        std::vector<unsigned char> vchSig(72);
+        tx.vin.push_back(CTxIn(COutPoint(txid, 0), CScript() << vchSig << ToByteVector(key.GetPubKey())));
+    }
+    tx.vout.resize(1);
+    tx.vout[0].nValue = 500 * COIN;
+    tx.vout[0].scriptPubKey = scriptPubKey;
+    CTransaction txSpend(tx);
+
+    while (state.KeepRunning()) {
+        assert(AreInputsStandard(txSpend, cache));
+    }
+}
+
+BENCHMARK(CCoinsViewCacheAreInputsStandard);
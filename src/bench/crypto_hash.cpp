@@ -0,0 +1,86 @@
+// Copyright (c) 2016 The Bitcoin Core developers
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "crypto/sha256.h"
+#include "hash.h"
+#include "primitives/block.h"
+
+/* Number of bytes to hash per iteration */
+static const uint64_t BUFFER_SIZE = 1000 * 1000;
+
+static void HashQuarkHeader(benchmark::State& state)
+{
+    CBlockHeader header;
+    header.nVersion = 3;
+    header.nTime = 1500000000;
+    header.nBits = 0x1e0ffff0;
+
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        HashQuark(BEGIN(header.nVersion), END(header.nNonce));
+    }
+}
+
+static void HashQuarkN2000Headers(benchmark::State& state)
+{
+    std::vector<CBlockHeader> vHeaders(2000);
+    for (size_t i = 0; i < vHeaders.size(); i++) {
+        vHeaders[i].nVersion = 3;
+        vHeaders[i].nTime = 1500000000 + i;
+        vHeaders[i].nBits = 0x1e0ffff0;
+    }
+
+    std::vector<uint256> vHashes;
+    while (state.KeepRunning()) {
+        vHeaders[0].nNonce++;
+        HashQuarkN(vHeaders, vHashes);
+    }
+}
+
+static void SHA256DoubleBuffer(benchmark::State& state)
+{
+    std::vector<uint8_t> in(BUFFER_SIZE, 0);
+    while (state.KeepRunning())
+        Hash(in.begin(), in.end());
+}
+
+static void SHA256D64_1024(benchmark::State& state, sha256_implementation::UseImplementation use)
+{
+    SHA256AutoDetect(use);
+    std::vector<uint8_t> in(64 * 1024, 0);
+    while (state.KeepRunning())
+        SHA256D64(in.data(), in.data(), 1024);
+    SHA256AutoDetect();
+}
+
+static void SHA256D64_1024_STANDARD(benchmark::State& state)
+{
+    SHA256D64_1024(state, sha256_implementation::STANDARD);
+}
+
+static void SHA256D64_1024_SSE41(benchmark::State& state)
+{
+    SHA256D64_1024(state, sha256_implementation::USE_SSE41);
+}
+
+static void SHA256D64_1024_AVX2(benchmark::State& state)
+{
+    SHA256D64_1024(state, sha256_implementation::USE_AVX2);
+}
+
+static void SHA256D64_1024_SHANI(benchmark::State& state)
+{
+    SHA256D64_1024(state, sha256_implementation::USE_SHANI);
+}
+
+BENCHMARK(HashQuarkHeader);
+BENCHMARK(HashQuarkN2000Headers);
+BENCHMARK(SHA256DoubleBuffer);
+BENCHMARK(SHA256D64_1024_STANDARD);
+BENCHMARK(SHA256D64_1024_SSE41);
+BENCHMARK(SHA256D64_1024_AVX2);
+BENCHMARK(SHA256D64_1024_SHANI);
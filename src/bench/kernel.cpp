@@ -0,0 +1,29 @@
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "amount.h"
+#include "kernel.h"
+#include "streams.h"
+
+// Checks the stake kernel of one input against the target, the part of
+// CheckProofOfStake that does not depend on the chain state
+static void CheckStakeKernel(benchmark::State& state)
+{
+    CDataStream ssUniqueID(SER_GETHASH, 0);
+    ssUniqueID << COutPoint(uint256(1), 0);
+
+    uint256 bnTarget;
+    bnTarget.SetCompact(0x1e0ffff0);
+    unsigned int nTimeTx = 1500000000;
+    uint256 hashProofOfStake;
+
+    while (state.KeepRunning()) {
+        nTimeTx++;
+        CheckStake(ssUniqueID, 1000 * COIN, 0x12345678, bnTarget, 1499990000, nTimeTx, hashProofOfStake);
+    }
+}
+
+BENCHMARK(CheckStakeKernel);
@@ -0,0 +1,45 @@
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "primitives/block.h"
+
+// Transactions in the benchmarked block
+static const int BLOCK_TXS = 2000;
+
+static void FillBlock(CBlock& block)
+{
+    for (int i = 0; i < BLOCK_TXS; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].scriptSig << i;
+        tx.vout.resize(1);
+        tx.vout[0].nValue = i;
+        block.vtx.push_back(CTransaction(tx));
+    }
+}
+
+static void BuildMerkleTree(benchmark::State& state)
+{
+    CBlock block;
+    FillBlock(block);
+
+    while (state.KeepRunning()) {
+        block.vMerkleTree.clear();
+        block.BuildMerkleTree();
+    }
+}
+
+static void GetMerkleRoot(benchmark::State& state)
+{
+    CBlock block;
+    FillBlock(block);
+
+    while (state.KeepRunning())
+        block.GetMerkleRoot();
+}
+
+BENCHMARK(BuildMerkleTree);
+BENCHMARK(GetMerkleRoot);
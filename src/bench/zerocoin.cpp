@@ -0,0 +1,105 @@
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chainparams.h"
+#include "libzerocoin/Accumulator.h"
+#include "libzerocoin/Coin.h"
+#include "libzerocoin/CoinSpend.h"
+
+using namespace libzerocoin;
+
+// Coins to accumulate, about a block's worth of mints of one denomination
+static const int ACCUMULATED_COINS = 10;
+
+static std::vector<PrivateCoin> MintCoins(const ZerocoinParams* params, CoinDenomination denom, int nCoins)
+{
+    std::vector<PrivateCoin> vCoins;
+    for (int i = 0; i < nCoins; i++)
+        vCoins.emplace_back(params, denom, true);
+    return vCoins;
+}
+
+static void ZerocoinAccumulatorIncrement(benchmark::State& state)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params(false);
+    std::vector<PrivateCoin> vCoins = MintCoins(params, CoinDenomination::ZQ_ONE, ACCUMULATED_COINS);
+
+    Accumulator accumulator(params, CoinDenomination::ZQ_ONE);
+    while (state.KeepRunning()) {
+        for (const PrivateCoin& coin : vCoins)
+            accumulator.increment(coin.getPublicCoin().getValue());
+    }
+}
+
+static void ZerocoinAccumulatorIncrementBatch(benchmark::State& state)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params(false);
+    std::vector<CBigNum> vValues;
+    for (const PrivateCoin& coin : MintCoins(params, CoinDenomination::ZQ_ONE, ACCUMULATED_COINS))
+        vValues.emplace_back(coin.getPublicCoin().getValue());
+
+    Accumulator accumulator(params, CoinDenomination::ZQ_ONE);
+    while (state.KeepRunning()) {
+        accumulator.incrementBatch(vValues);
+    }
+}
+
+static void ZerocoinWitnessGeneration(benchmark::State& state)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params(false);
+    std::vector<PrivateCoin> vCoins = MintCoins(params, CoinDenomination::ZQ_ONE, ACCUMULATED_COINS + 1);
+    const PublicCoin& coinOwn = vCoins[0].getPublicCoin();
+
+    Accumulator accumulator(params, CoinDenomination::ZQ_ONE);
+    for (const PrivateCoin& coin : vCoins)
+        accumulator += coin.getPublicCoin();
+
+    while (state.KeepRunning()) {
+        AccumulatorWitness witness(params, Accumulator(params, CoinDenomination::ZQ_ONE), coinOwn);
+        for (unsigned int i = 1; i < vCoins.size(); i++)
+            witness += vCoins[i].getPublicCoin();
+        assert(witness.VerifyWitness(accumulator, coinOwn));
+    }
+}
+
+static void ZerocoinSpendCreate(benchmark::State& state)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params(false);
+    std::vector<PrivateCoin> vCoins = MintCoins(params, CoinDenomination::ZQ_ONE, 2);
+
+    Accumulator accumulator(params, CoinDenomination::ZQ_ONE);
+    AccumulatorWitness witness(params, accumulator, vCoins[0].getPublicCoin());
+    accumulator += vCoins[0].getPublicCoin();
+    accumulator += vCoins[1].getPublicCoin();
+    witness += vCoins[1].getPublicCoin();
+
+    while (state.KeepRunning()) {
+        CoinSpend spend(params, params, vCoins[0], accumulator, 0, witness, 0, SpendType::SPEND);
+    }
+}
+
+static void ZerocoinSpendVerify(benchmark::State& state)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params(false);
+    std::vector<PrivateCoin> vCoins = MintCoins(params, CoinDenomination::ZQ_ONE, 2);
+
+    Accumulator accumulator(params, CoinDenomination::ZQ_ONE);
+    AccumulatorWitness witness(params, accumulator, vCoins[0].getPublicCoin());
+    accumulator += vCoins[0].getPublicCoin();
+    accumulator += vCoins[1].getPublicCoin();
+    witness += vCoins[1].getPublicCoin();
+    CoinSpend spend(params, params, vCoins[0], accumulator, 0, witness, 0, SpendType::SPEND);
+
+    while (state.KeepRunning()) {
+        assert(spend.Verify(accumulator));
+    }
+}
+
+BENCHMARK(ZerocoinAccumulatorIncrement);
+BENCHMARK(ZerocoinAccumulatorIncrementBatch);
+BENCHMARK(ZerocoinWitnessGeneration);
+BENCHMARK(ZerocoinSpendCreate);
+BENCHMARK(ZerocoinSpendVerify);
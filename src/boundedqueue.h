@@ -0,0 +1,166 @@
+// Copyright (c) 2015-2018 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef nativecoin_BOUNDEDQUEUE_H
+#define nativecoin_BOUNDEDQUEUE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * A multi producer, multi consumer FIFO queue with a maximum size.
+ * Pushing to a full (or closed) queue fails instead of blocking, so
+ * producers can shed load. Counts the queue depth and how long the
+ * elements waited before they were popped.
+ */
+template <typename T>
+class CBoundedQueue
+{
+public:
+    struct Stats {
+        size_t nDepth;
+        size_t nMaxDepth;
+        size_t nCapacity;
+        uint64_t nPushed;
+        uint64_t nPopped;
+        uint64_t nRejected;
+        int64_t nTotalWaitMicros;
+        int64_t nMaxWaitMicros;
+    };
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::pair<T, clock::time_point> > queue;
+    size_t nCapacity;
+    bool fClosed;
+    Stats stats;
+
+    typedef typename std::deque<std::pair<T, clock::time_point> >::iterator iterator;
+
+    /** Remove the element at it, recording how long it was queued */
+    T take(iterator& it)
+    {
+        int64_t nWait = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - it->second).count();
+        stats.nTotalWaitMicros += nWait;
+        if (nWait > stats.nMaxWaitMicros)
+            stats.nMaxWaitMicros = nWait;
+        stats.nPopped++;
+
+        T value(std::move(it->first));
+        it = queue.erase(it);
+        return value;
+    }
+
+public:
+    explicit CBoundedQueue(size_t nCapacityIn) : nCapacity(nCapacityIn), fClosed(false), stats()
+    {
+        stats.nCapacity = nCapacity;
+    }
+
+    /** Add value to the back of the queue, false if the queue is full or closed */
+    bool try_push(const T& value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (fClosed || queue.size() >= nCapacity) {
+                stats.nRejected++;
+                return false;
+            }
+            queue.emplace_back(value, clock::now());
+            stats.nPushed++;
+            if (queue.size() > stats.nMaxDepth)
+                stats.nMaxDepth = queue.size();
+        }
+        condition.notify_one();
+        return true;
+    }
+
+    /** Pop the oldest element if there is one */
+    bool try_pop(T& value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty())
+            return false;
+        auto it = queue.begin();
+        value = take(it);
+        return true;
+    }
+
+    /** Wait up to timeout for an element, false on timeout or when the queue is closed and empty */
+    template <typename Rep, typename Period>
+    bool pop_for(T& value, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!condition.wait_for(lock, timeout, [this] { return !queue.empty() || fClosed; }) || queue.empty())
+            return false;
+        auto it = queue.begin();
+        value = take(it);
+        return true;
+    }
+
+    /** Move up to nMax of the oldest elements to out, returns how many were moved */
+    size_t drain(std::vector<T>& out, size_t nMax = std::numeric_limits<size_t>::max())
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t n = 0;
+        auto it = queue.begin();
+        while (it != queue.end() && n < nMax) {
+            out.emplace_back(take(it));
+            n++;
+        }
+        return n;
+    }
+
+    /** Move the elements matching pred to out, oldest first, returns how many were moved */
+    template <typename Pred>
+    size_t drain_if(std::vector<T>& out, Pred pred)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t n = 0;
+        for (auto it = queue.begin(); it != queue.end();) {
+            if (pred(it->first)) {
+                out.emplace_back(take(it));
+                n++;
+            } else {
+                ++it;
+            }
+        }
+        return n;
+    }
+
+    /** Refuse further pushes and wake up all the waiting consumers */
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fClosed = true;
+        }
+        condition.notify_all();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.size();
+    }
+
+    Stats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats ret = stats;
+        ret.nDepth = queue.size();
+        return ret;
+    }
+};
+
+#endif //nativecoin_BOUNDEDQUEUE_H
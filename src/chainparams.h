@@ -228,6 +228,7 @@ public:
     virtual void setDefaultConsistencyChecks(bool aDefaultConsistencyChecks) = 0;
     virtual void setAllowMinDifficultyBlocks(bool aAllowMinDifficultyBlocks) = 0;
     virtual void setSkipProofOfWorkCheck(bool aSkipProofOfWorkCheck) = 0;
+    virtual void setZerocoinStartHeight(int anZerocoinStartHeight) = 0;
 };
 
 
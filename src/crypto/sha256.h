@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string>
 
 /** A hasher class for SHA-256. */
 class CSHA256
@@ -25,4 +26,27 @@ public:
     CSHA256& Reset();
 };
 
+namespace sha256_implementation
+{
+enum UseImplementation : uint8_t {
+    STANDARD = 0,
+    USE_SSE41 = 1 << 0,
+    USE_AVX2 = 1 << 1,
+    USE_SHANI = 1 << 2,
+    USE_ALL = USE_SSE41 | USE_AVX2 | USE_SHANI,
+};
+}
+
+/** Select the fastest SHA-256 implementations the CPU supports, out of the ones allowed by use.
+ *  They are checked against the portable code, which is kept when that fails.
+ *  Returns a description of the implementations in use.
+ */
+std::string SHA256AutoDetect(sha256_implementation::UseImplementation use = sha256_implementation::USE_ALL);
+
+/** Compute the double-SHA256 of each of a number of 64-byte inputs.
+ *  output: blocks * 32 bytes
+ *  input:  blocks * 64 bytes
+ */
+void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
@@ -0,0 +1,132 @@
+// Copyright (c) 2017-2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// 8-way double-SHA256 of 64-byte inputs with AVX2, one input per 32-bit lane.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "crypto/common.h"
+
+namespace sha256d64_avx2
+{
+namespace
+{
+const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+const uint32_t INIT[8] = {0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul, 0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul};
+
+__m256i inline K8(uint32_t x) { return _mm256_set1_epi32(x); }
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+__m256i inline And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+__m256i inline Rot(__m256i x, int n) { return Or(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n)); }
+
+__m256i inline Ch(__m256i x, __m256i y, __m256i z) { return Xor(z, And(x, Xor(y, z))); }
+__m256i inline Maj(__m256i x, __m256i y, __m256i z) { return Or(And(x, y), And(z, Or(x, y))); }
+__m256i inline Sigma0(__m256i x) { return Xor(Xor(Rot(x, 2), Rot(x, 13)), Rot(x, 22)); }
+__m256i inline Sigma1(__m256i x) { return Xor(Xor(Rot(x, 6), Rot(x, 11)), Rot(x, 25)); }
+__m256i inline sigma0(__m256i x) { return Xor(Xor(Rot(x, 7), Rot(x, 18)), _mm256_srli_epi32(x, 3)); }
+__m256i inline sigma1(__m256i x) { return Xor(Xor(Rot(x, 17), Rot(x, 19)), _mm256_srli_epi32(x, 10)); }
+
+/** One SHA-256 compression of the eight lanes. */
+void inline Compress(__m256i* s, __m256i* w)
+{
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for (int i = 0; i < 64; i++) {
+        if (i >= 16)
+            w[i & 15] = Add(Add(w[i & 15], sigma1(w[(i - 2) & 15])), Add(w[(i - 7) & 15], sigma0(w[(i - 15) & 15])));
+        __m256i t1 = Add(Add(Add(h, Sigma1(e)), Add(Ch(e, f, g), K8(K[i]))), w[i & 15]);
+        __m256i t2 = Add(Sigma0(a), Maj(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = Add(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = Add(t1, t2);
+    }
+    s[0] = Add(s[0], a);
+    s[1] = Add(s[1], b);
+    s[2] = Add(s[2], c);
+    s[3] = Add(s[3], d);
+    s[4] = Add(s[4], e);
+    s[5] = Add(s[5], f);
+    s[6] = Add(s[6], g);
+    s[7] = Add(s[7], h);
+}
+
+void inline Initialize(__m256i* s)
+{
+    for (int i = 0; i < 8; i++)
+        s[i] = K8(INIT[i]);
+}
+
+/** The big endian 32-bit word at offset of each of the eight inputs. */
+__m256i inline Read8(const unsigned char* in, int offset)
+{
+    return _mm256_set_epi32(ReadBE32(in + 448 + offset), ReadBE32(in + 384 + offset), ReadBE32(in + 320 + offset), ReadBE32(in + 256 + offset),
+                            ReadBE32(in + 192 + offset), ReadBE32(in + 128 + offset), ReadBE32(in + 64 + offset), ReadBE32(in + offset));
+}
+
+void inline Write8(unsigned char* out, int offset, __m256i v)
+{
+    WriteBE32(out + offset, _mm256_extract_epi32(v, 0));
+    WriteBE32(out + 32 + offset, _mm256_extract_epi32(v, 1));
+    WriteBE32(out + 64 + offset, _mm256_extract_epi32(v, 2));
+    WriteBE32(out + 96 + offset, _mm256_extract_epi32(v, 3));
+    WriteBE32(out + 128 + offset, _mm256_extract_epi32(v, 4));
+    WriteBE32(out + 160 + offset, _mm256_extract_epi32(v, 5));
+    WriteBE32(out + 192 + offset, _mm256_extract_epi32(v, 6));
+    WriteBE32(out + 224 + offset, _mm256_extract_epi32(v, 7));
+}
+} // namespace
+
+void Transform_8way(unsigned char* out, const unsigned char* in)
+{
+    __m256i s[8], w[16];
+
+    // First hash: the 64 bytes of input, then the padding block of a 64-byte message
+    Initialize(s);
+    for (int i = 0; i < 16; i++)
+        w[i] = Read8(in, 4 * i);
+    Compress(s, w);
+    __m256i t[8];
+    for (int i = 0; i < 8; i++)
+        t[i] = s[i];
+    w[0] = K8(0x80000000);
+    for (int i = 1; i < 15; i++)
+        w[i] = K8(0);
+    w[15] = K8(512);
+    Compress(t, w);
+
+    // Second hash: the 32-byte first hash, padded in the same block
+    Initialize(s);
+    for (int i = 0; i < 8; i++)
+        w[i] = t[i];
+    w[8] = K8(0x80000000);
+    for (int i = 9; i < 15; i++)
+        w[i] = K8(0);
+    w[15] = K8(256);
+    Compress(s, w);
+
+    for (int i = 0; i < 8; i++)
+        Write8(out, 4 * i, s[i]);
+}
+
+} // namespace sha256d64_avx2
+
+#endif
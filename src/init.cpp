@@ -18,10 +18,12 @@
 #include "amount.h"
 #include "checkpoints.h"
 #include "compat/sanity.h"
+#include "crypto/sha256.h"
 #include "httpserver.h"
 #include "httprpc.h"
 #include "invalid.h"
 #include "key.h"
+#include "libzerocoin/SerialNumberSignatureOfKnowledge.h"
 #include "main.h"
 #include "masternode-budget.h"
 #include "masternode-payments.h"
@@ -30,6 +32,7 @@
 #include "miner.h"
 #include "net.h"
 #include "rpc/server.h"
+#include "script/sigcache.h"
 #include "script/standard.h"
 #include "scheduler.h"
 #include "spork.h"
@@ -41,6 +44,7 @@
 #include "utilmoneystr.h"
 #include "validationinterface.h"
 #include "zNATIVE/accumulatorcheckpoints.h"
+#include "zNATIVE/spendcache.h"
 #include "zNATIVEchain.h"
 
 #ifdef ENABLE_WALLET
@@ -394,6 +398,8 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-maxreorg=<n>", strprintf(_("Set the Maximum reorg depth (default: %u)"), Params(CBaseChainParams::MAIN).MaxReorganizationDepth()));
     strUsage += HelpMessageOpt("-maxorphantx=<n>", strprintf(_("Keep at most <n> unconnectable transactions in memory (default: %u)"), DEFAULT_MAX_ORPHAN_TRANSACTIONS));
     strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"), -(int)boost::thread::hardware_concurrency(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
+    strUsage += HelpMessageOpt("-parzkp=<n>", strprintf(_("Set the number of threads verifying zerocoin serial number proofs (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"), -(int)boost::thread::hardware_concurrency(), MAX_ZKPCHECK_THREADS, DEFAULT_ZKPCHECK_THREADS));
+    strUsage += HelpMessageOpt("-parzerocoin=<n>", strprintf(_("Set the number of threads verifying the zerocoin spends of a block (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"), -(int)boost::thread::hardware_concurrency(), MAX_ZEROCOINCHECK_THREADS, DEFAULT_ZEROCOINCHECK_THREADS));
 #ifndef WIN32
     strUsage += HelpMessageOpt("-pid=<file>", strprintf(_("Specify pid file (default: %s)"), "nativecoind.pid"));
 #endif
@@ -401,6 +407,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-reindexaccumulators", _("Reindex the accumulator database") + " " + _("on startup"));
     strUsage += HelpMessageOpt("-reindexmoneysupply", _("Reindex the N8V and zNATIVE money supply statistics") + " " + _("on startup"));
     strUsage += HelpMessageOpt("-resync", _("Delete blockchain folders and resync from scratch") + " " + _("on startup"));
+    strUsage += HelpMessageOpt("-trustblockindex", strprintf(_("Load the block index with its stored hashes up to the last checkpoint and check them in the background (default: %u)"), DEFAULT_TRUST_BLOCK_INDEX));
 #if !defined(WIN32)
     strUsage += HelpMessageOpt("-sysperms", _("Create new files with system default permissions, instead of umask 077 (only effective with disabled wallet functionality)"));
 #endif
@@ -428,6 +435,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-permitbaremultisig", strprintf(_("Relay non-P2SH multisig (default: %u)"), 1));
     strUsage += HelpMessageOpt("-peerbloomfilters", strprintf(_("Support filtering of blocks and transaction with bloom filters (default: %u)"), DEFAULT_PEERBLOOMFILTERS));
     strUsage += HelpMessageOpt("-peerbloomfilterszc", strprintf(_("Support the zerocoin light node protocol (default: %u)"), DEFAULT_PEERBLOOMFILTERS_ZC));
+    strUsage += HelpMessageOpt("-lightworkers=<n>", strprintf(_("Number of threads serving witness requests of zerocoin light nodes (default: %u)"), DEFAULT_LIGHT_WORKERS));
     strUsage += HelpMessageOpt("-port=<port>", strprintf(_("Listen for connections on <port> (default: %u or testnet: %u)"), 16740, 51474));
     strUsage += HelpMessageOpt("-proxy=<ip:port>", _("Connect through SOCKS5 proxy"));
     strUsage += HelpMessageOpt("-proxyrandomize", strprintf(_("Randomize credentials for every proxy connection. This enables Tor stream isolation (default: %u)"), 1));
@@ -488,6 +496,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageGroup(_("Debugging/Testing options:"));
     strUsage += HelpMessageOpt("-uacomment=<cmt>", _("Append comment to the user agent string"));
     if (GetBoolArg("-help-debug", false)) {
+        strUsage += HelpMessageOpt("-checkaccumulators", strprintf("Recalculate accumulator checkpoints from the database and compare them to the values rolled forward in memory (default: %u)", 0));
         strUsage += HelpMessageOpt("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. Also sets -checkmempool (default: %u)", Params(CBaseChainParams::MAIN).DefaultConsistencyChecks()));
         strUsage += HelpMessageOpt("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u)", Params(CBaseChainParams::MAIN).DefaultConsistencyChecks()));
         strUsage += HelpMessageOpt("-checkpoints", strprintf(_("Only accept block chain matching built-in checkpoints (default: %u)"), 1));
@@ -518,7 +527,8 @@ std::string HelpMessage(HelpMessageMode mode)
     if (GetBoolArg("-help-debug", false)) {
         strUsage += HelpMessageOpt("-limitfreerelay=<n>", strprintf(_("Continuously rate-limit free transactions to <n>*1000 bytes per minute (default:%u)"), 15));
         strUsage += HelpMessageOpt("-relaypriority", strprintf(_("Require high priority for relaying free or low-fee transactions (default:%u)"), 1));
-        strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf(_("Limit size of signature cache to <n> entries (default: %u)"), 50000));
+        strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf(_("Limit size of signature cache to <n> MiB, not a number of entries as before (default: %u, max: %u)"), DEFAULT_MAX_SIG_CACHE_SIZE, MAX_MAX_SIG_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-maxzcspendcachesize=<n>", strprintf(_("Limit size of validated zerocoin spend cache to <n> entries (default: %u)"), DEFAULT_MAX_ZEROCOIN_SPEND_CACHE_SIZE));
     }
     strUsage += HelpMessageOpt("-minrelaytxfee=<amt>", strprintf(_("Fees (in N8V/Kb) smaller than this are considered zero fee for relaying (default: %s)"), FormatMoney(::minRelayTxFee.GetFeePerK())));
     strUsage += HelpMessageOpt("-printtoconsole", strprintf(_("Send trace/debug info to console instead of debug.log file (default: %u)"), 0));
@@ -933,6 +943,24 @@ bool AppInit2()
     else if (nScriptCheckThreads > MAX_SCRIPTCHECK_THREADS)
         nScriptCheckThreads = MAX_SCRIPTCHECK_THREADS;
 
+    // -parzkp follows the same rules as -par
+    libzerocoin::nSoKVerifyThreads = GetArg("-parzkp", DEFAULT_ZKPCHECK_THREADS);
+    if (libzerocoin::nSoKVerifyThreads <= 0)
+        libzerocoin::nSoKVerifyThreads += boost::thread::hardware_concurrency();
+    if (libzerocoin::nSoKVerifyThreads <= 1)
+        libzerocoin::nSoKVerifyThreads = 0;
+    else if (libzerocoin::nSoKVerifyThreads > MAX_ZKPCHECK_THREADS)
+        libzerocoin::nSoKVerifyThreads = MAX_ZKPCHECK_THREADS;
+
+    // -parzerocoin follows the same rules as -par
+    nZerocoinSpendCheckThreads = GetArg("-parzerocoin", DEFAULT_ZEROCOINCHECK_THREADS);
+    if (nZerocoinSpendCheckThreads <= 0)
+        nZerocoinSpendCheckThreads += boost::thread::hardware_concurrency();
+    if (nZerocoinSpendCheckThreads <= 1)
+        nZerocoinSpendCheckThreads = 0;
+    else if (nZerocoinSpendCheckThreads > MAX_ZEROCOINCHECK_THREADS)
+        nZerocoinSpendCheckThreads = MAX_ZEROCOINCHECK_THREADS;
+
     fServer = GetBoolArg("-server", false);
     setvbuf(stdout, NULL, _IOLBF, 0); /// ***TODO*** do we still need this after -printtoconsole is gone?
 
@@ -1006,6 +1034,11 @@ bool AppInit2()
     std::string strWalletFile = GetArg("-wallet", "wallet.dat");
 #endif // ENABLE_WALLET
 
+    // -maxsigcachesize used to be a number of entries, such a value is too large for a size in MiB
+    int64_t nMaxSigCacheSize = GetArg("-maxsigcachesize", DEFAULT_MAX_SIG_CACHE_SIZE);
+    if (nMaxSigCacheSize > MAX_MAX_SIG_CACHE_SIZE)
+        return InitError(strprintf(_("-maxsigcachesize is now a size in MiB, %d is above the maximum of %d MiB"), nMaxSigCacheSize, MAX_MAX_SIG_CACHE_SIZE));
+
     fIsBareMultisigStd = GetBoolArg("-permitbaremultisig", true) != 0;
     nMaxDatacarrierBytes = GetArg("-datacarriersize", nMaxDatacarrierBytes);
 
@@ -1023,8 +1056,12 @@ bool AppInit2()
 
     // ********************************************************* Step 4: application initialization: dir lock, daemonize, pidfile, debug log
 
+    // Select the SHA256 implementation for this CPU
+    std::string strSHA256Implementation = SHA256AutoDetect();
+
     // Initialize elliptic curve code
     ECC_Start();
+    InitSignatureCache();
     globalVerifyHandle.reset(new ECCVerifyHandle());
 
     // Sanity check
@@ -1055,6 +1092,7 @@ bool AppInit2()
     LogPrintf("\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n");
     LogPrintf("NativeCoin version %s (%s)\n", FormatFullVersion(), CLIENT_DATE);
     LogPrintf("Using OpenSSL version %s\n", SSLeay_version(SSLEAY_VERSION));
+    LogPrintf("Using the '%s' SHA256 implementation\n", strSHA256Implementation);
 #ifdef ENABLE_WALLET
     LogPrintf("Using BerkeleyDB version %s\n", DbEnv::version(0, 0, 0));
 #endif
@@ -1072,6 +1110,18 @@ bool AppInit2()
             threadGroup.create_thread(&ThreadScriptCheck);
     }
 
+    LogPrintf("Using %u threads for zerocoin proof verification\n", libzerocoin::nSoKVerifyThreads);
+    if (libzerocoin::nSoKVerifyThreads) {
+        for (int i = 0; i < libzerocoin::nSoKVerifyThreads - 1; i++)
+            threadGroup.create_thread(&libzerocoin::ThreadSoKVerify);
+    }
+
+    LogPrintf("Using %u threads for zerocoin spend verification\n", nZerocoinSpendCheckThreads);
+    if (nZerocoinSpendCheckThreads) {
+        for (int i = 0; i < nZerocoinSpendCheckThreads - 1; i++)
+            threadGroup.create_thread(&ThreadZerocoinSpendCheck);
+    }
+
     if (mapArgs.count("-sporkkey")) // spork priv key
     {
         if (!sporkManager.SetPrivKey(GetArg("-sporkkey", "")))
@@ -1453,6 +1503,10 @@ bool AppInit2()
                 zerocoinDB = new CZerocoinDB(0, false, fReindex);
                 pSporkDB = new CSporkDB(0, false, false);
 
+                uiInterface.InitMessage(_("Loading zerocoin serials..."));
+                if (!zerocoinDB->LoadSerialFilter())
+                    LogPrintf("Failed to load the spent zerocoin serials, looking them up on disk\n");
+
                 pblocktree = new CBlockTreeDB(nBlockTreeDBCache, false, fReindex);
                 pcoinsdbview = new CCoinsViewDB(nCoinDBCache, false, fReindex);
                 pcoinscatcher = new CCoinsViewErrorCatcher(pcoinsdbview);
@@ -1494,8 +1548,10 @@ bool AppInit2()
                 invalid_out::LoadOutpoints();
                 invalid_out::LoadSerials();
 
-                // Drop all information from the zerocoinDB and repopulate
-                if (GetBoolArg("-reindexzerocoin", false)) {
+                // Drop all information from the zerocoinDB and repopulate, or finish doing so after an interruption
+                int nReindexHeight;
+                uint256 hashReindex;
+                if (GetBoolArg("-reindexzerocoin", false) || zerocoinDB->ReadReindexProgress(nReindexHeight, hashReindex)) {
                     if (chainActive.Height() > Params().Zerocoin_StartHeight()) {
                         uiInterface.InitMessage(_("Reindexing zerocoin database..."));
                         std::string strError = ReindexZerocoinDB();
@@ -1801,6 +1857,8 @@ bool AppInit2()
             vImportFiles.push_back(strFile);
     }
     threadGroup.create_thread(boost::bind(&ThreadImport, vImportFiles));
+    if (GetBlockIndexVerifyStatus().nTrustedHeight >= 0)
+        threadGroup.create_thread(boost::bind(&TraceThread<void (*)()>, "blkidxverify", &ThreadVerifyBlockIndexHashes));
     if (chainActive.Tip() == NULL) {
         LogPrintf("Waiting for genesis block to be imported...\n");
         while (!fRequestShutdown && chainActive.Tip() == NULL)
@@ -47,6 +47,25 @@ void Accumulator::increment(const CBigNum& bnValue) {
     this->value = this->value.pow_mod(bnValue, this->params->accumulatorModulus);
 }
 
+void Accumulator::incrementBatch(const std::vector<CBigNum>& vValues) {
+    if (vValues.empty())
+        return;
+
+    // Multiply neighbours level by level so the operands of each multiplication stay balanced
+    std::vector<CBigNum> vProducts(vValues);
+    while (vProducts.size() > 1) {
+        const size_t nPairs = vProducts.size() / 2;
+        for (size_t i = 0; i < nPairs; i++)
+            vProducts[i] = vProducts[2 * i] * vProducts[2 * i + 1];
+        if (vProducts.size() % 2)
+            vProducts[nPairs] = vProducts.back();
+        vProducts.resize(vProducts.size() - nPairs);
+    }
+
+    // "old accumulator"^{e_1}^{e_2}... = "old accumulator"^{e_1 * e_2 * ...} mod N
+    increment(vProducts[0]);
+}
+
 void Accumulator::accumulate(const PublicCoin& coin) {
     // Make sure we're initialized
     if(!(this->value)) {
@@ -75,6 +94,10 @@ CoinDenomination Accumulator::getDenomination() const {
     return this->denomination;
 }
 
+const AccumulatorAndProofParams* Accumulator::getParams() const {
+    return this->params;
+}
+
 const CBigNum& Accumulator::getValue() const {
     return this->value;
 }
@@ -62,7 +62,17 @@ public:
     void accumulate(const PublicCoin &coin);
     void increment(const CBigNum& bnValue);
 
+    /** Increment the accumulator by several values at once.
+     * The values are multiplied together with a product tree so the
+     * accumulator is raised to a single exponent.
+     *
+     * @param vValues the values to accumulate, their order does not matter
+     **/
+    void incrementBatch(const std::vector<CBigNum>& vValues);
+
     CoinDenomination getDenomination() const;
+    /** Get the parameters the accumulator was made with */
+    const AccumulatorAndProofParams* getParams() const;
     /** Get the accumulator result
      *
      * @return a CBigNum containing the result.
@@ -119,14 +119,56 @@ bool AccumulatorProofOfKnowledge:: Verify(const Accumulator& a, const CBigNum& v
 
 	CBigNum c = CBigNum(hasher.GetHash()); //this hash should be of length k_prime bits
 
-	CBigNum st_1_prime = (valueOfCommitmentToCoin.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * sg.pow_mod(s_alpha, params->accumulatorPoKCommitmentGroup.modulus) * sh.pow_mod(s_phi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-	CBigNum st_2_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * ((valueOfCommitmentToCoin * sg.inverse(params->accumulatorPoKCommitmentGroup.modulus)).pow_mod(s_gamma, params->accumulatorPoKCommitmentGroup.modulus)) * sh.pow_mod(s_psi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-	CBigNum st_3_prime = (sg.pow_mod(c, params->accumulatorPoKCommitmentGroup.modulus) * (sg * valueOfCommitmentToCoin).pow_mod(s_sigma, params->accumulatorPoKCommitmentGroup.modulus) * sh.pow_mod(s_xi, params->accumulatorPoKCommitmentGroup.modulus)) % params->accumulatorPoKCommitmentGroup.modulus;
-
-	CBigNum t_1_prime = (C_r.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_zeta, params->accumulatorModulus) * g_n.pow_mod(s_epsilon, params->accumulatorModulus)) % params->accumulatorModulus;
-	CBigNum t_2_prime = (C_e.pow_mod(c, params->accumulatorModulus) * h_n.pow_mod(s_eta, params->accumulatorModulus) * g_n.pow_mod(s_alpha, params->accumulatorModulus)) % params->accumulatorModulus;
-	CBigNum t_3_prime = ((a.getValue()).pow_mod(c, params->accumulatorModulus) * C_u.pow_mod(s_alpha, params->accumulatorModulus) * ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) % params->accumulatorModulus;
-	CBigNum t_4_prime = (C_r.pow_mod(s_alpha, params->accumulatorModulus) * ((h_n.inverse(params->accumulatorModulus)).pow_mod(s_delta, params->accumulatorModulus)) * ((g_n.inverse(params->accumulatorModulus)).pow_mod(s_beta, params->accumulatorModulus))) % params->accumulatorModulus;
+	// The fixed generators are raised with their precomputed powers, h_n^-1 and g_n^-1 by negating the exponent.
+	// The two variable bases of t_3 share their squarings.
+	const IntegerGroupParams& sGroup = params->accumulatorPoKCommitmentGroup;
+	const IntegerGroupParams& nGroup = params->accumulatorQRNCommitmentGroup;
+
+	// The products are built in place to keep temporaries out of the allocator
+	const CBigNum& N = params->accumulatorModulus;
+	CBigNum term;
+
+	CBigNum st_1_prime, st_2_prime, st_3_prime;
+	valueOfCommitmentToCoin.pow_mod_into(st_1_prime, c, sGroup.modulus);
+	sGroup.gPowers.pow_mod_into(term, s_alpha);
+	st_1_prime.mul_mod_inplace(term, sGroup.modulus);
+	sGroup.hPowers.pow_mod_into(term, s_phi);
+	st_1_prime.mul_mod_inplace(term, sGroup.modulus);
+
+	valueOfCommitmentToCoin.mul_mod(sg.inverse(sGroup.modulus), sGroup.modulus).pow_mod_into(st_2_prime, s_gamma, sGroup.modulus);
+	sGroup.gPowers.pow_mod_into(term, c);
+	st_2_prime.mul_mod_inplace(term, sGroup.modulus);
+	sGroup.hPowers.pow_mod_into(term, s_psi);
+	st_2_prime.mul_mod_inplace(term, sGroup.modulus);
+
+	sg.mul_mod(valueOfCommitmentToCoin, sGroup.modulus).pow_mod_into(st_3_prime, s_sigma, sGroup.modulus);
+	sGroup.gPowers.pow_mod_into(term, c);
+	st_3_prime.mul_mod_inplace(term, sGroup.modulus);
+	sGroup.hPowers.pow_mod_into(term, s_xi);
+	st_3_prime.mul_mod_inplace(term, sGroup.modulus);
+
+	CBigNum t_1_prime, t_2_prime, t_3_prime, t_4_prime;
+	C_r.pow_mod_into(t_1_prime, c, N);
+	nGroup.hPowers.pow_mod_into(term, s_zeta);
+	t_1_prime.mul_mod_inplace(term, N);
+	nGroup.gPowers.pow_mod_into(term, s_epsilon);
+	t_1_prime.mul_mod_inplace(term, N);
+
+	C_e.pow_mod_into(t_2_prime, c, N);
+	nGroup.hPowers.pow_mod_into(term, s_eta);
+	t_2_prime.mul_mod_inplace(term, N);
+	nGroup.gPowers.pow_mod_into(term, s_alpha);
+	t_2_prime.mul_mod_inplace(term, N);
+
+	t_3_prime = CBigNum::multi_pow_mod({a.getValue(), C_u}, {c, s_alpha}, N);
+	nGroup.hPowers.pow_mod_into(term, -s_beta);
+	t_3_prime.mul_mod_inplace(term, N);
+
+	C_r.pow_mod_into(t_4_prime, s_alpha, N);
+	nGroup.hPowers.pow_mod_into(term, -s_delta);
+	t_4_prime.mul_mod_inplace(term, N);
+	nGroup.gPowers.pow_mod_into(term, -s_beta);
+	t_4_prime.mul_mod_inplace(term, N);
 
 	bool result_st1 = (st_1 == st_1_prime);
 	bool result_st2 = (st_2 == st_2_prime);
@@ -36,6 +36,8 @@ public:
 	/** Verifies that  a commitment c is accumulated in accumulated a
 	 */
 	bool Verify(const Accumulator& a,const CBigNum& valueOfCommitmentToCoin) const;
+	/** The parameters the proof is made and checked in */
+	const AccumulatorAndProofParams* getParams() const { return params; }
 	
 	ADD_SERIALIZE_METHODS;
   template <typename Stream, typename Operation>  inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
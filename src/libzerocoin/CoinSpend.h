@@ -113,6 +113,8 @@ public:
     CBigNum getAccCommitment() const { return accCommitmentToCoinValue; }
     CBigNum getSerialComm() const { return serialCommitmentToCoinValue; }
     uint8_t getVersion() const { return version; }
+    const AccumulatorAndProofParams* getAccumulatorProofParams() const { return accumulatorPoK.getParams(); }
+    const ZerocoinParams* getSerialNumberProofParams() const { return serialNumberSoK.getParams(); }
     CPubKey getPubKey() const { return pubkey; }
     SpendType getSpendType() const { return spendType; }
     std::vector<unsigned char> getSignature() const { return vchSig; }
@@ -125,14 +125,17 @@ bool CommitmentProofOfKnowledge::Verify(const CBigNum& A, const CBigNum& B) cons
 	}
 
 	// Compute T1 = g1^S1 * h1^S2 * inverse(A^{challenge}) mod p1
-	CBigNum T1 = A.pow_mod(this->challenge, ap->modulus).inverse(ap->modulus).mul_mod(
-	                (ap->g.pow_mod(S1, ap->modulus).mul_mod(ap->h.pow_mod(S2, ap->modulus), ap->modulus)),
-	                ap->modulus);
+	CBigNum T1, T2, term;
+	ap->gPowers.pow_mod_into(T1, S1);
+	ap->hPowers.pow_mod_into(term, S2);
+	T1.mul_mod_inplace(term, ap->modulus);
+	T1.mul_mod_inplace(A.pow_mod(this->challenge, ap->modulus).inverse(ap->modulus), ap->modulus);
 
 	// Compute T2 = g2^S1 * h2^S3 * inverse(B^{challenge}) mod p2
-	CBigNum T2 = B.pow_mod(this->challenge, bp->modulus).inverse(bp->modulus).mul_mod(
-	                (bp->g.pow_mod(S1, bp->modulus).mul_mod(bp->h.pow_mod(S3, bp->modulus), bp->modulus)),
-	                bp->modulus);
+	bp->gPowers.pow_mod_into(T2, S1);
+	bp->hPowers.pow_mod_into(term, S3);
+	T2.mul_mod_inplace(term, bp->modulus);
+	T2.mul_mod_inplace(B.pow_mod(this->challenge, bp->modulus).inverse(bp->modulus), bp->modulus);
 
 	// Hash T1 and T2 along with all of the public parameters
 	CBigNum computedChallenge = calculateChallenge(A, B, T1, T2);
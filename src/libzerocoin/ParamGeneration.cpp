@@ -11,11 +11,14 @@
 // Copyright (c) 2017 The nativecoin developers
 
 #include "ParamGeneration.h"
+#include "ParamsCache.h"
 #include "bignum.h"
 #include <string>
 #include <cmath>
 #include "hash.h"
+#include "streams.h"
 #include "uint256.h"
+#include "utilstrencodings.h"
 
 using namespace std;
 
@@ -59,6 +62,50 @@ CalculateParams(ZerocoinParams &params, CBigNum N, string aux, uint32_t security
 	// Set the accumulator modulus to "N".
 	params.accumulatorParams.accumulatorModulus = N;
 
+	// The groups are derived by a slow search for primes, known moduli
+	// get them from the compiled-in cache instead.
+	if (!LoadCachedGroups(params, N, aux, securityLevel))
+		CalculateGroups(params, N, aux, securityLevel);
+
+	// Calculate the accumulator base, which we calculate as "u = C**2 mod N"
+	// where C is an arbitrary value. In the unlikely case that "u = 1" we increment
+	// "C" and repeat.
+	CBigNum constant(ACCUMULATOR_BASE_CONSTANT);
+	params.accumulatorParams.accumulatorBase = CBigNum(1);
+	for (uint32_t count = 0; count < MAX_ACCUMGEN_ATTEMPTS && params.accumulatorParams.accumulatorBase.isOne(); count++) {
+		params.accumulatorParams.accumulatorBase = constant.pow_mod(CBigNum(2), params.accumulatorParams.accumulatorModulus);
+	}
+
+	// Compute the accumulator range. The upper range is the largest possible coin commitment value.
+	// The lower range is sqrt(upper range) + 1. Since OpenSSL doesn't have
+	// a square root function we use a slightly higher approximation.
+	params.accumulatorParams.maxCoinValue = params.coinCommitmentGroup.modulus;
+	params.accumulatorParams.minCoinValue = CBigNum(2).pow((params.coinCommitmentGroup.modulus.bitSize() / 2) + 3);
+
+	// If all went well, mark params as successfully initialized.
+	params.accumulatorParams.initialized = true;
+
+	// If all went well, mark params as successfully initialized.
+	params.initialized = true;
+}
+
+/// \brief Derive the groups of a set of Zerocoin parameters from a modulus "N".
+/// \param params           The parameters to fill in
+/// \param N                A trusted RSA modulus
+/// \param aux              An optional auxiliary string used in derivation
+/// \param securityLevel    A security level
+///
+/// \throws         std::runtime_error if the process fails
+///
+/// Fills in the coin commitment, serial number and accumulator proof groups
+/// and the QRN commitment generators. This is the expensive part of
+/// CalculateParams(): it searches for primes of up to a few thousand bits.
+///
+void
+CalculateGroups(ZerocoinParams &params, CBigNum N, string aux, uint32_t securityLevel)
+{
+	uint32_t NLen = N.bitSize();
+
 	// Calculate the required size of the field "F_p" into which
 	// we're embedding the coin commitment group. This may throw an
 	// exception if the securityLevel is too large to be supported
@@ -93,27 +140,105 @@ CalculateParams(ZerocoinParams &params, CBigNum N, string aux, uint32_t security
 	params.accumulatorParams.accumulatorQRNCommitmentGroup.h = generateIntegerFromSeed(NLen - 1,
 	        calculateSeed(N, aux, securityLevel, STRING_QRNCOMMIT_GROUPH),
 											 &resultCtr).pow_mod(CBigNum(2), N);
+}
 
-	// Calculate the accumulator base, which we calculate as "u = C**2 mod N"
-	// where C is an arbitrary value. In the unlikely case that "u = 1" we increment
-	// "C" and repeat.
-	CBigNum constant(ACCUMULATOR_BASE_CONSTANT);
-	params.accumulatorParams.accumulatorBase = CBigNum(1);
-	for (uint32_t count = 0; count < MAX_ACCUMGEN_ATTEMPTS && params.accumulatorParams.accumulatorBase.isOne(); count++) {
-		params.accumulatorParams.accumulatorBase = constant.pow_mod(CBigNum(2), params.accumulatorParams.accumulatorModulus);
-	}
+/// \brief Identify a set of parameters in the cache.
+///
+/// Returns the hash of <modulus>||<securitylevel>||<auxString>, the
+/// same inputs the groups are derived from.
+///
+uint256
+calculateParamsCacheKey(CBigNum modulus, string auxString, uint32_t securityLevel)
+{
+	CHashWriter hasher(0,0);
 
-	// Compute the accumulator range. The upper range is the largest possible coin commitment value.
-	// The lower range is sqrt(upper range) + 1. Since OpenSSL doesn't have
-	// a square root function we use a slightly higher approximation.
-	params.accumulatorParams.maxCoinValue = params.coinCommitmentGroup.modulus;
-	params.accumulatorParams.minCoinValue = CBigNum(2).pow((params.coinCommitmentGroup.modulus.bitSize() / 2) + 3);
+	hasher << modulus;
+	hasher << string("||");
+	hasher << securityLevel;
+	hasher << string("||");
+	hasher << auxString;
 
-	// If all went well, mark params as successfully initialized.
-	params.accumulatorParams.initialized = true;
+	return hasher.GetHash();
+}
 
-	// If all went well, mark params as successfully initialized.
-	params.initialized = true;
+/// \brief Serialize the derived groups of a set of parameters.
+///
+/// Returns the hex string the cache in ParamsCache.h stores for the modulus
+/// of params. Used to regenerate the cache.
+///
+string
+SerializeCachedGroups(const ZerocoinParams &params)
+{
+	CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+	ss << params.coinCommitmentGroup;
+	ss << params.serialNumberSoKCommitmentGroup;
+	ss << params.accumulatorParams.accumulatorPoKCommitmentGroup;
+	ss << params.accumulatorParams.accumulatorQRNCommitmentGroup.g;
+	ss << params.accumulatorParams.accumulatorQRNCommitmentGroup.h;
+
+	return HexStr(ss.begin(), ss.end());
+}
+
+/// \brief Fill in the derived groups of a set of parameters from the cache.
+/// \param params           The parameters to fill in
+/// \param N                A trusted RSA modulus
+/// \param aux              An optional auxiliary string used in derivation
+/// \param securityLevel    A security level
+///
+/// Returns false if the cache has no entry for these inputs or the entry
+/// does not pass the checks, params is left untouched then. The entries
+/// are checked against their checksum and against the relations between
+/// the groups that CalculateGroups() guarantees.
+///
+bool
+LoadCachedGroups(ZerocoinParams &params, CBigNum N, string aux, uint32_t securityLevel)
+{
+	uint256 key = calculateParamsCacheKey(N, aux, securityLevel);
+
+	for (const CachedGroups& entry : vCachedGroups) {
+		if (uint256S(entry.strKey) != key)
+			continue;
+
+		std::vector<unsigned char> vch = ParseHex(entry.strGroups);
+		CHashWriter hasher(0,0);
+		hasher << key;
+		hasher << vch;
+		if (hasher.GetHash() != uint256S(entry.strChecksum))
+			return false;
+
+		IntegerGroupParams coinCommitmentGroup, serialNumberSoKCommitmentGroup, accumulatorPoKCommitmentGroup;
+		CBigNum qrnG, qrnH;
+		try {
+			CDataStream ss(vch, SER_NETWORK, PROTOCOL_VERSION);
+			ss >> coinCommitmentGroup;
+			ss >> serialNumberSoKCommitmentGroup;
+			ss >> accumulatorPoKCommitmentGroup;
+			ss >> qrnG;
+			ss >> qrnH;
+		} catch (const std::exception&) {
+			return false;
+		}
+
+		// The lengths CalculateGroups() derives the coin commitment group with
+		uint32_t pLen = 0;
+		uint32_t qLen = 0;
+		calculateGroupParamLengths(N.bitSize() - 2, securityLevel, &pLen, &qLen);
+		if ((uint32_t)coinCommitmentGroup.modulus.bitSize() < pLen ||
+		    (uint32_t)coinCommitmentGroup.groupOrder.bitSize() < qLen ||
+		    serialNumberSoKCommitmentGroup.groupOrder != coinCommitmentGroup.modulus ||
+		    (uint32_t)accumulatorPoKCommitmentGroup.groupOrder.bitSize() < qLen + 1 ||
+		    qrnG <= CBigNum(1) || qrnG >= N || qrnH <= CBigNum(1) || qrnH >= N)
+			return false;
+
+		params.coinCommitmentGroup = coinCommitmentGroup;
+		params.serialNumberSoKCommitmentGroup = serialNumberSoKCommitmentGroup;
+		params.accumulatorParams.accumulatorPoKCommitmentGroup = accumulatorPoKCommitmentGroup;
+		params.accumulatorParams.accumulatorQRNCommitmentGroup.g = qrnG;
+		params.accumulatorParams.accumulatorQRNCommitmentGroup.h = qrnH;
+		return true;
+	}
+
+	return false;
 }
 
 /// \brief Format a seed string by hashing several values.
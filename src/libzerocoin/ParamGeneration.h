@@ -17,6 +17,9 @@
 namespace libzerocoin {
 
 void CalculateParams(ZerocoinParams &params, CBigNum N, std::string aux, uint32_t securityLevel);
+void CalculateGroups(ZerocoinParams &params, CBigNum N, std::string aux, uint32_t securityLevel);
+bool LoadCachedGroups(ZerocoinParams &params, CBigNum N, std::string aux, uint32_t securityLevel);
+std::string SerializeCachedGroups(const ZerocoinParams &params);
 void calculateGroupParamLengths(uint32_t maxPLen, uint32_t securityLevel,
                                 uint32_t *pLen, uint32_t *qLen);
 
@@ -39,6 +42,7 @@ uint256             calculateSeed(CBigNum modulus, std::string auxString, uint32
 uint256             calculateGeneratorSeed(uint256 seed, uint256 pSeed, uint256 qSeed, std::string label, uint32_t index, uint32_t count);
 
 uint256             calculateHash(uint256 input);
+uint256             calculateParamsCacheKey(CBigNum modulus, std::string auxString, uint32_t securityLevel);
 IntegerGroupParams  deriveIntegerGroupParams(uint256 seed, uint32_t pLen, uint32_t qLen);
 IntegerGroupParams  deriveIntegerGroupFromOrder(CBigNum &groupOrder);
 void                calculateGroupModulusAndOrder(uint256 seed, uint32_t pLen, uint32_t qLen,
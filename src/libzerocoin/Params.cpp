@@ -28,6 +28,18 @@ ZerocoinParams::ZerocoinParams(CBigNum N, uint32_t securityLevel) {
 	// Generate the parameters
 	CalculateParams(*this, N, ZEROCOIN_PROTOCOL_VERSION, securityLevel);
 
+	// Precompute the powers of the generators the proofs raise to public exponents.
+	// The QRN generators have no known order, their exponents in the accumulator
+	// proof of knowledge run up to k_prime + k_dprime bits past the modulus.
+	this->coinCommitmentGroup.PrecomputePowers(this->coinCommitmentGroup.modulus,
+	        this->coinCommitmentGroup.groupOrder.bitSize());
+	this->serialNumberSoKCommitmentGroup.PrecomputePowers(this->serialNumberSoKCommitmentGroup.modulus,
+	        this->serialNumberSoKCommitmentGroup.groupOrder.bitSize());
+	this->accumulatorParams.accumulatorPoKCommitmentGroup.PrecomputePowers(this->accumulatorParams.accumulatorPoKCommitmentGroup.modulus,
+	        this->accumulatorParams.accumulatorPoKCommitmentGroup.groupOrder.bitSize());
+	this->accumulatorParams.accumulatorQRNCommitmentGroup.PrecomputePowers(N,
+	        N.bitSize() + this->accumulatorParams.k_prime + this->accumulatorParams.k_dprime + 2);
+
 	this->accumulatorParams.initialized = true;
 	this->initialized = true;
 }
@@ -40,6 +52,11 @@ IntegerGroupParams::IntegerGroupParams() {
 	this->initialized = false;
 }
 
+void IntegerGroupParams::PrecomputePowers(const CBigNum& m, unsigned int nMaxBits) {
+	this->gPowers = CBigNumFixedBase(this->g, m, this->groupOrder, nMaxBits);
+	this->hPowers = CBigNumFixedBase(this->h, m, this->groupOrder, nMaxBits);
+}
+
 CBigNum IntegerGroupParams::randomElement() const {
 	// The generator of the group raised
 	// to a random number less than the order of the group
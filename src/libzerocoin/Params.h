@@ -56,6 +56,23 @@ public:
 	 */
 	CBigNum groupOrder;
 
+	/**
+	 * Precomputed powers of g and h, not serialized.
+	 * Only for public exponents, see CBigNumFixedBase.
+	 * A table holds 15 numbers of the modulus size per 4 bits of exponent. The two QRN tables
+	 * take about 9 MB with the 2048-bit V2 modulus and 13 MB with the 2466-bit V1 one, the
+	 * other groups about 3 MB together, so the V1 and V2 params hold about 28 MB of tables.
+	 */
+	CBigNumFixedBase gPowers;
+	CBigNumFixedBase hPowers;
+
+	/**
+	 * Builds gPowers and hPowers.
+	 * @param m        the modulus g and h are raised by (the QRN group does not store it)
+	 * @param nMaxBits the longest exponent to cover, after reduction by the group order when it is known
+	 */
+	void PrecomputePowers(const CBigNum& m, unsigned int nMaxBits);
+
 	ADD_SERIALIZE_METHODS;
   template <typename Stream, typename Operation>  inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
 		    READWRITE(initialized);
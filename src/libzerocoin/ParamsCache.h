@@ -0,0 +1,107 @@
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef PARAMSCACHE_H_
+#define PARAMSCACHE_H_
+
+/**
+ * The groups CalculateGroups() derives from the moduli of the chain
+ * parameters, so that node startup does not have to search for primes.
+ *
+ * strKey is calculateParamsCacheKey() of the modulus, security level and
+ * protocol version the groups were derived with, strChecksum the hash of
+ * the key and the serialized groups, strGroups SerializeCachedGroups().
+ * The zerocoin_params_cache test fails when an entry is out of date and
+ * prints the values to replace it with.
+ */
+struct CachedGroups {
+    const char* strKey;
+    const char* strChecksum;
+    const char* strGroups;
+};
+
+static const CachedGroups vCachedGroups[] = {
+    // Chain modulus read as hex (Zerocoin_Params(true))
+    {"64b2d9e61e99d2ae49ee246b9cc9996ce00a8fa219a769f139c476b31e6d2a3e",
+     "6ca8557c3bda326b638136f0c468a1db269e332fa9b65044c43a7fbbb7f7a049",
+     "008008bc30ab82c20b90d6f25a995147b79982939a33176328a2430414232869cfc7c7e9371e5c31b3715f476021bf8a"
+     "282ecd81df9b6366a30e2bfeac5fde332caa7a81761d4fba23f45a8a523eec553152b196d167553a8ab861aaf06ce423"
+     "2dfbe455542c2f5a6d4a0c90bfa99c4cfe57e50b0253ab52ff045be47554ac71661680d71edf1faed7cdecf913fcd694"
+     "e633c7c50a07ba78682aff6ebf5a03ae13ec73215005f76d184a20729da868fb8fdd7b4bb827b2798b7dba5a2b50144f"
+     "1cf8c59dab37abb94000b7c342c11d418487c4b1d53856a365ee30469023e5d17a416f9bf96c1e605fcb32e90d45c44f"
+     "4d8adf0b727470f6ccb75780f5b672750c7e07819ffe13070b2c7746ed631b53a59e214562e6ef63bf0d62d2f38b0349"
+     "bf27d768b9131eae792efb6f057d868b3f6568800e9bbdf01cfa50a20057cc15dd7880f895450f44c07634de61b6baa2"
+     "06edf499c4157b1452db1903d57cd9e4fd38789dee6451411ededbbc3f1a4bbdb285802356713293671bb81dbbb56cb5"
+     "770ab9d00021d3d2b9a02443e626fe79dc0eb54c049b001ba38ccc72f58d7119466d38a84ccd000081734e7a0e8c99bd"
+     "cec1c4f20f89ace13d524a617c5870b9a4123c3e7971b8287f6376bab25d8f95d801c5681f4e39555d301e28b36f48ab"
+     "3588c1ed092405f938d6574bbc7fba132c9d134eaf29f3f6810bd9be0b448a10fee79fdbd344d6ed0e7514e0ac4c9636"
+     "1d84d530538759af6008bc8445eccf75de051fd67f1cee44b90c81b600eb8af4c2882b7a9f1dda04bb4c57037a65e4ce"
+     "9af7fc8bfa407b3dc269593cae4527a196f09881a4e0d1895970a8cdab1b128a210ad3a18e6dcdc054dbe84892513c17"
+     "41745a41ef7b4190e22465023640df6321ef4b6460fb9f318113688f8d8eb1753e50421fe6e88a3d8ba16287fd5b1500"
+     "8abe5a221852e77b1017183781cf62e726e99c1161a97f32029fa5f8c8c297d4803a1faaaf935294832eb3cfaf90c864"
+     "892fb2dadd6bace3214c167d2e750c6f34e3600f4848befeb473d235a9c8fccc4e9ee15cf394372577f48c118f8cb1cf"
+     "1e8daa8361db96d9e80f61891f42f23e1679e9e81962b0714b98893bcf5b78768c1f34fc3b53ed68ca4ea966f25c819f"
+     "fe13070b2c7746ed631b53a59e214562e6ef63bf0d62d2f38b0349bf27d768b9131eae792efb6f057d868b3f6568800e"
+     "9bbdf01cfa50a20057cc15dd7880f895450f44c07634de61b6baa206edf499c4157b1452db1903d57cd9e4fd38789dee"
+     "6451411ededbbc3f1a4bbdb285802356713293671bb81dbbb56cb5770ab9d000004668220bac4912c9c854042e1f5db2"
+     "3f40ece2a788ba9650351c873cdaaaeddbcc52a445784311c8a92cf4f0d2db49f9447e742944959c8e9bd5eb42b06015"
+     "9453ce6d906abc0746069a18d307da3c865e09c60d5c9ab946e5ea6213b584dee9279570bad8250c60c6c93c6cadbee3"
+     "99370d1fadd0aeed7a9b395947cd70ee078c467195d65ad47fdb8b442e2f044653093c1bf9f678d2de9f55f35645f2f3"
+     "961ba9cb155bb43b0d4324bfa6739cc60dc30a46835ac77eb1eab8a10d91d3af7892cb101ab6b3f1d34bf078aafc3946"
+     "d97a926e19092131ecb06c3a2e9b3e192817217ef86800cf7ab07828e89a39e76811f3ea08652a01fd3501abbd79fc1f"
+     "48a07c44e48671db13cf786bbf4a100461319fbd7d4fd51a5f8fdf0b9e03a9c95e41bc79ff552404cfe52d202f4fe46b"
+     "468be130e0c408eaf08f47ba39ae9cb21fd7e648a38848e45fc65d135749392f24d92fa300919d5e6719bb033fba37f8"
+     "9db3f81791ad3b9ac0e8aa8e5f8f8930659ca8a2a888ece82ccd03a791fb72caded6feda83d0dc23b311d6f1430653f6"
+     "5476f7f957672c57d7d25776e0644552662cfdb56ac370aca32684ce7e926ffe109cd6fcbd3ce9f8485ca587dc4b4e73"
+     "9ec105a9873d0aac32e47e045c2287e9acc9cd14457596e6fed8b83aeb74e21cb5b43db768ce8663f8a59af49395f7bf"
+     "3db8efbd8edaad6a4e7c2b801db90893562c889193483c277f194a7a1148715d44231646a0a9b58676afd7a32ae77017"
+     "1b02ba14817f7a65c0712dc1dc2e6c01fd350112ff1be82210cc7b91480ca37f54ca487e4b38c93ac5a121e63f723517"
+     "02a6ec93ca2aa93f14eb2f27d85fb0fd2b17dfce3db5e00105d6445521435c1a86862f9f5d185b537bb2c4456381270a"
+     "1c93d2052254c01416b194153ae3d8d392103a385f61d17710e9f27d48d17f69d2b371e5d5f476d1fda4419cef126084"
+     "f10959143a63c346c31daac6169b19ffcbcdf6a803d797597d841a629721c50c0c6383e6ceb07ce81f48a7c5f4b4a7fd"
+     "e36cc8e51e78ee96715033b34ae9c2c324be23346e319b64f71e83dfc397d73bbb57a7b11f8a4392706fa46f6943a50b"
+     "b0eb29c1a3ae7a4b5ef50d032952a04ba57ece8bc0025732ae1c58d2fdc40bbc98db0835e8d1942d840c2be69736dfeb"
+     "e480d2a76fa85e82b29b761e2113b5cb8c72637d71b20feaee17608a0e591af82c23815f7f961501"},
+    // Chain modulus read as decimal (Zerocoin_Params(false))
+    {"3e2deaa9a1e50cabb2141226ed137bbcd92e33b43d659847b241f9276d5107aa",
+     "bc7aac6c4b3c679c60b47271c145f2291e13bb269e23c86168fedcb015017634",
+     "00816241ddd0fb4ff0135644fc6a01a305d1b41eb726f8d065a5f16c0910feecf50cf74d55171d03a5aad583aba9d4f6"
+     "8193d3e5a6b2483a1e29ed21ade72a845cd4c6df7af8f21c67ac391ec4463271dd457f33daa1ebd3e763ec5c9129c405"
+     "b0159ab26382fdf9ccb30f25d9dc23281bf9b459cbb69a01508e2579fa8d50d67f9a00812286d3d3ea48f7994f41974a"
+     "6091f967931d47c1883b326cb629eff09995b792d9a01c5efa12da6af217ceeabcf7be849b3f2ef5c438038f23872eb3"
+     "b9e30f7925040498630e110d1454b5a7c144f74d740bd26f0c4d5effac2395b48ee6e6f0ac94dc6dfe8431c63e38b7eb"
+     "9e38607b197bee25b62897a1fb3ce29d46ddbbcc008141a23b722430932b8d50c2371d96f797602c969cd78537671d5f"
+     "6f5c712ff838e40bac7593eec42edde18f91d43fe9d4e91508ddf5e2f909ec2c37593d9e644183471b6b98bc4b89827d"
+     "e6c70172a4297703d9a08094e5c0ca2632794e26ae725e6f7044289a479436c95df554608a67d640e37383f8178e6f67"
+     "c4f76cc4f1e50021e3f96a57e8fa870415da0aadd764834a6657b52203f5a51af5fe03ebfc393aa30000813200998628"
+     "da295409d5bc20407d855ea1db59304246d4a58244f37a7ed1916c34e6722d5a9cc7ee708e88c8d489d5dbe871d1197c"
+     "adc704d12ef88546ed2b4b51c33d7ee675fc63fe7eebbd58b66c8308fcc925ee1f0a9b48eeaf90412eaad517fa594373"
+     "fed47de13c04b39777088e6b18f2f19f9f320d667e185a334ff75a758139d79133b20ecfe4587112275348c2c9c3723e"
+     "7f793537586c2f02173a048311b065906f129c81d6a43fd6058f15185bd185815013e149dfb9b2e572616a63992cc9c6"
+     "a4f8fe395b69d2d86a68aab1a2579dd105fd690f94dbe6d336276460ebd342b9cf79faf9714874a769c40b8c18807786"
+     "dc6ff1955ad8bbdf6138cc57e20582af6859c2fecaa26789063bc777161346f35928b95ae47fc3af34620bbbf7c7343b"
+     "07f6d0f471512ced72bcb7c34c292bd9d989bf0abec9c473fe163f5facb224d75c2e5ace7b58f7fd0fe8d1197efe1f93"
+     "1602c0bd2fd58e2fc329f9923071496b61a3bc80db77ec625ea37439a43d25ee7c16b6122b47a09905b2498cb835430f"
+     "018141a23b722430932b8d50c2371d96f797602c969cd78537671d5f6f5c712ff838e40bac7593eec42edde18f91d43f"
+     "e9d4e91508ddf5e2f909ec2c37593d9e644183471b6b98bc4b89827de6c70172a4297703d9a08094e5c0ca2632794e26"
+     "ae725e6f7044289a479436c95df554608a67d640e37383f8178e6f67c4f76cc4f1e5000046a70b1c22c39c9679568d2e"
+     "99998deff51d103263de21c2db04596bfa7c83d704f05eba4c3299a5200dbb54af59b34a9022adebf14ba5f50f519a40"
+     "e05617d4c68a648e86d50146863ac22ab1142d0b67404f3d0c46760531e88b836440ebdc86e3f3ad8cbd82fd692e57d9"
+     "3cedb41d3eb64210499412627f9c429529704e79ce9697ade6f62967a6f97ff408044671b8d7a5ed0bf150d5967980c9"
+     "2ef106dae8e99919009b8409988cd4802a442a920afd6b25daff97a519a3dfff13afb61f5873aa7a1b19090866bbdb96"
+     "720245a95f78b3090f215fb2382ff77707910da81cacbb2c97688fe4f3d3d88ddaf6ee7d5551506b3c7201fd00013af6"
+     "7773e96c967550708dd569175ff4fc93e23623907e9c6bf1515e6ca969f276f1705b7779a367e9182b36cfbab21b24fe"
+     "8c1e4ab8f469d1ccf60ead6993d8496f1e4071c1f222e0eac9b443113c95f721c2979257f04594087b6e5fae7d48ba32"
+     "1949733100fb4dd669480236296d23797b1ad6ca71ec66b28387c511d90bb045bc8f31d557c9d82e19bc4f6bb920e3a5"
+     "1e7a5d809c13a5c631968df49feafb2d18794a3b0d81ed047ae416d22bd9901da29074ad0e562964d3c791064467da0f"
+     "68282310a0f5cab2691d2bb51a6be079587b988a6b63cdfefe28791324ff4a1ece68b96dfdb0ffca722bfc97c0baf9da"
+     "774dbbbecac9fe4a2b4e56dc2463fd000102d847efc664c5b5f7b6e9dc95d38fb4622a4484284e74364f8ab3606d4b6a"
+     "9e10a2f63c32007de97991eb26609a64e15ca8567f80ec3402f016b111fe2147f6d00ef551cbd70b32ee28f1570739e0"
+     "faa4c64d2ddcbb912566000ef7148a35a073109ec46378cdac024426e785a5228dc6e2eabfa9eb04b89fe04c1b37c746"
+     "f1504557b262b2cb45d305790077d4394b326819f235cce029aa4c2108f5595a3bd7757dccd261107cb3cfce786bb7b6"
+     "4e0d0fa1bd4d45a41161b15292fd386f7248b437bd4e747d2b014e1d49117739d9be077ee44f526d2bf5d3d412fdb2d2"
+     "81f030a77fef640cea9557d2ec0faf1236151bfb523ded6025bdc409d157bea361"},
+};
+
+#endif /* PARAMSCACHE_H_ */
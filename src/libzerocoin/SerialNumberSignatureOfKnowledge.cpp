@@ -13,10 +13,64 @@
 
 #include "bignum.h"
 #include <streams.h>
+#include "checkqueue.h"
 #include "SerialNumberSignatureOfKnowledge.h"
 
 namespace libzerocoin {
 
+int nSoKVerifyThreads = 0;
+
+/**
+ * Closure representing the computation of a single tprime value in
+ * SerialNumberSignatureOfKnowledge::Verify(). The zkp iterations are
+ * independent of each other, only hashing the results has to be done in order.
+ */
+class CSoKIterationCheck
+{
+private:
+    const SerialNumberSignatureOfKnowledge* pSoK;
+    const CBigNum* pSerial;
+    const CBigNum* pCommitmentValue;
+    CBigNum* pResult;
+    uint32_t nIteration;
+    bool fValidationRange;
+
+public:
+    CSoKIterationCheck() : pSoK(NULL), pSerial(NULL), pCommitmentValue(NULL), pResult(NULL), nIteration(0), fValidationRange(true) {}
+    CSoKIterationCheck(const SerialNumberSignatureOfKnowledge* pSoKIn, uint32_t nIterationIn, const CBigNum* pSerialIn,
+                       const CBigNum* pCommitmentValueIn, bool fValidationRangeIn, CBigNum* pResultIn) :
+            pSoK(pSoKIn), pSerial(pSerialIn), pCommitmentValue(pCommitmentValueIn), pResult(pResultIn),
+            nIteration(nIterationIn), fValidationRange(fValidationRangeIn) {}
+
+    bool operator()()
+    {
+        return pSoK->calculateTPrime(nIteration, *pSerial, *pCommitmentValue, fValidationRange, *pResult);
+    }
+
+    void swap(CSoKIterationCheck& check)
+    {
+        std::swap(pSoK, check.pSoK);
+        std::swap(pSerial, check.pSerial);
+        std::swap(pCommitmentValue, check.pCommitmentValue);
+        std::swap(pResult, check.pResult);
+        std::swap(nIteration, check.nIteration);
+        std::swap(fValidationRange, check.fValidationRange);
+    }
+};
+
+static CCheckQueue<CSoKIterationCheck> sokcheckqueue(4);
+
+// A CCheckQueue has a single master at a time. Verify() can be entered from
+// several threads (mempool, block connection, wallet), so whoever does not get
+// the queue computes its iterations itself.
+static boost::mutex csSoKCheckQueue;
+
+void ThreadSoKVerify()
+{
+    RenameThread("nativecoin-sokcheck");
+    sokcheckqueue.Thread();
+}
+
 SerialNumberSignatureOfKnowledge::SerialNumberSignatureOfKnowledge(const ZerocoinParams* p): params(p) { }
 
 // Use one 256 bit seed and concatenate 4 unique 256 bit hashes to make a 1024 bit hash
@@ -110,7 +164,20 @@ SerialNumberSignatureOfKnowledge::SerialNumberSignatureOfKnowledge(const
 }
 
 inline CBigNum SerialNumberSignatureOfKnowledge::challengeCalculation(const CBigNum& a_exp,const CBigNum& b_exp,
-        const CBigNum& h_exp) const {
+        const CBigNum& h_exp, bool fPublicExponents) const {
+
+    // When verifying, the exponents come from the proof and the precomputed powers can be used.
+    // The modulus of the coin commitment group is the order of the SoK group.
+    if (fPublicExponents) {
+        CBigNum exponent, term, result;
+        params->coinCommitmentGroup.gPowers.pow_mod_into(exponent, a_exp);
+        params->coinCommitmentGroup.hPowers.pow_mod_into(term, b_exp);
+        exponent.mul_mod_inplace(term, params->serialNumberSoKCommitmentGroup.groupOrder);
+
+        params->serialNumberSoKCommitmentGroup.gPowers.pow_mod_into(result, exponent);
+        params->serialNumberSoKCommitmentGroup.hPowers.pow_mod_into(term, h_exp);
+        return result.mul_mod_inplace(term, params->serialNumberSoKCommitmentGroup.modulus);
+    }
 
     CBigNum a = params->coinCommitmentGroup.g;
     CBigNum b = params->coinCommitmentGroup.h;
@@ -125,11 +192,6 @@ inline CBigNum SerialNumberSignatureOfKnowledge::challengeCalculation(const CBig
 
 bool SerialNumberSignatureOfKnowledge::Verify(const CBigNum& coinSerialNumber, const CBigNum& valueOfCommitmentToCoin,
         const uint256 msghash, bool isInParamsValidationRange) const {
-    CBigNum a = params->coinCommitmentGroup.g;
-    CBigNum b = params->coinCommitmentGroup.h;
-    CBigNum g = params->serialNumberSoKCommitmentGroup.g;
-    CBigNum h = params->serialNumberSoKCommitmentGroup.h;
-
     //// Params validation.
     if(isInParamsValidationRange) {
         // Check that the serial is within the max size
@@ -146,31 +208,51 @@ bool SerialNumberSignatureOfKnowledge::Verify(const CBigNum& coinSerialNumber, c
     hasher << *params << valueOfCommitmentToCoin << coinSerialNumber << msghash;
 
     vector<CBigNum> tprime(params->zkp_iterations);
-    unsigned char *hashbytes = (unsigned char*) &this->hash;
 
-    try {
+    boost::unique_lock<boost::mutex> lock(csSoKCheckQueue, boost::defer_lock);
+    if (nSoKVerifyThreads > 1 && lock.try_lock()) {
+        CCheckQueueControl<CSoKIterationCheck> control(&sokcheckqueue);
+        std::vector<CSoKIterationCheck> vChecks;
+        vChecks.reserve(params->zkp_iterations);
+        for (uint32_t i = 0; i < params->zkp_iterations; i++)
+            vChecks.push_back(CSoKIterationCheck(this, i, &coinSerialNumber, &valueOfCommitmentToCoin, isInParamsValidationRange, &tprime[i]));
+        control.Add(vChecks);
+        if (!control.Wait())
+            return false;
+    } else {
         for (uint32_t i = 0; i < params->zkp_iterations; i++) {
-            int bit = i % 8;
-            int byte = i / 8;
-            bool challenge_bit = ((hashbytes[byte] >> bit) & 0x01);
-            if (challenge_bit) {
-                CBigNum bn = SeedTo1024(sprime[i].getuint256());
-                if (bn > params->serialNumberSoKCommitmentGroup.groupOrder && isInParamsValidationRange)
-                    return error("SoK Verify() :: sprime in pos %d not in valid range", i);
-                tprime[i] = challengeCalculation(coinSerialNumber, s_notprime[i], bn);
-            } else {
-                CBigNum exp = b.pow_mod(s_notprime[i], params->serialNumberSoKCommitmentGroup.groupOrder);
-                tprime[i] = ((valueOfCommitmentToCoin.pow_mod(exp, params->serialNumberSoKCommitmentGroup.modulus) %
-                              params->serialNumberSoKCommitmentGroup.modulus) *
-                             (h.pow_mod(sprime[i], params->serialNumberSoKCommitmentGroup.modulus) %
-                              params->serialNumberSoKCommitmentGroup.modulus)) %
-                            params->serialNumberSoKCommitmentGroup.modulus;
-            }
+            if (!calculateTPrime(i, coinSerialNumber, valueOfCommitmentToCoin, isInParamsValidationRange, tprime[i]))
+                return false;
         }
-        for (uint32_t i = 0; i < params->zkp_iterations; i++) {
-            hasher << tprime[i];
+    }
+
+    for (uint32_t i = 0; i < params->zkp_iterations; i++) {
+        hasher << tprime[i];
+    }
+    return hasher.GetHash() == hash;
+}
+
+bool SerialNumberSignatureOfKnowledge::calculateTPrime(uint32_t i, const CBigNum& coinSerialNumber, const CBigNum& valueOfCommitmentToCoin,
+        bool isInParamsValidationRange, CBigNum& tprime) const {
+    const unsigned char *hashbytes = (const unsigned char*) &this->hash;
+
+    try {
+        int bit = i % 8;
+        int byte = i / 8;
+        bool challenge_bit = ((hashbytes[byte] >> bit) & 0x01);
+        if (challenge_bit) {
+            CBigNum bn = SeedTo1024(sprime[i].getuint256());
+            if (bn > params->serialNumberSoKCommitmentGroup.groupOrder && isInParamsValidationRange)
+                return error("SoK Verify() :: sprime in pos %d not in valid range", i);
+            tprime = challengeCalculation(coinSerialNumber, s_notprime[i], bn, true);
+        } else {
+            CBigNum exp, term;
+            params->coinCommitmentGroup.hPowers.pow_mod_into(exp, s_notprime[i]);
+            valueOfCommitmentToCoin.pow_mod_into(tprime, exp, params->serialNumberSoKCommitmentGroup.modulus);
+            params->serialNumberSoKCommitmentGroup.hPowers.pow_mod_into(term, sprime[i]);
+            tprime.mul_mod_inplace(term, params->serialNumberSoKCommitmentGroup.modulus);
         }
-        return hasher.GetHash() == hash;
+        return true;
     }catch (std::range_error e){
         return error("SoK Verify() :: sprime invalid range.");
     }
@@ -28,6 +28,15 @@
 using namespace std;
 namespace libzerocoin {
 
+/** Number of threads (including the calling one) Verify() spreads the zkp iterations over,
+ *  values below 2 keep the verification on the calling thread */
+extern int nSoKVerifyThreads;
+
+/** Worker loop of the zkp iteration verification pool, run it in nSoKVerifyThreads - 1 threads */
+void ThreadSoKVerify();
+
+class CSoKIterationCheck;
+
 /**A Signature of knowledge on the hash of metadata attesting that the signer knows the values
  *  necessary to open a commitment which contains a coin(which it self is of course a commitment)
  * with a given serial number.
@@ -50,6 +59,8 @@ public:
 	 * @return
 	 */
     bool Verify(const CBigNum& coinSerialNumber, const CBigNum& valueOfCommitmentToCoin,const uint256 msghash, bool isInParamsValidationRange = true) const;
+	/** The parameters the signature is made and checked in */
+	const ZerocoinParams* getParams() const { return params; }
 	ADD_SERIALIZE_METHODS;
   template <typename Stream, typename Operation>  inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
 	    READWRITE(s_notprime);
@@ -57,6 +68,7 @@ public:
 	    READWRITE(hash);
 	}
 private:
+	friend class CSoKIterationCheck;
 	const ZerocoinParams* params;
 	// challenge hash
 	uint256 hash; //TODO For efficiency, should this be a bitset where Templates define params?
@@ -68,7 +80,9 @@ private:
 	vector<CBigNum> s_notprime;
 	vector<CBigNum> sprime;
 	inline CBigNum challengeCalculation(const CBigNum& a_exp, const CBigNum& b_exp,
-	                                   const CBigNum& h_exp) const;
+	                                   const CBigNum& h_exp, bool fPublicExponents = false) const;
+	bool calculateTPrime(uint32_t i, const CBigNum& coinSerialNumber, const CBigNum& valueOfCommitmentToCoin,
+	                     bool isInParamsValidationRange, CBigNum& tprime) const;
 };
 
 } /* namespace libzerocoin */
@@ -36,6 +36,7 @@ public:
 /** C++ wrapper for BIGNUM */
 class CBigNum
 {
+    friend class CBigNumFixedBase;
 #if defined(USE_NUM_OPENSSL)
     BIGNUM* bn;
 #endif
@@ -137,6 +138,15 @@ public:
      */
     CBigNum mul_mod(const CBigNum& b, const CBigNum& m) const;
 
+    /**
+     * in-place modular multiplication: this = (this * b) mod m
+     * The product goes through a per-thread scratch number, so nothing is
+     * allocated once this number and the scratch have grown to size.
+     * @param b operand
+     * @param m modulus
+     */
+    CBigNum& mul_mod_inplace(const CBigNum& b, const CBigNum& m);
+
     /**
      * modular exponentiation: this^e mod n
      * @param e exponent
@@ -144,6 +154,24 @@ public:
      */
     CBigNum pow_mod(const CBigNum& e, const CBigNum& m) const;
 
+    /**
+     * modular exponentiation into an existing number: ret = this^e mod m
+     * @param ret receives the result, its storage is reused
+     * @param e exponent
+     * @param m modulus
+     */
+    void pow_mod_into(CBigNum& ret, const CBigNum& e, const CBigNum& m) const;
+
+    /**
+     * simultaneous modular exponentiation: prod(bases[i]^exps[i]) mod m
+     * The squarings are shared between the terms (Straus/Shamir), so it is
+     * not constant time: only use it with public exponents.
+     * @param bases the bases
+     * @param exps the exponents, one per base
+     * @param m modulus
+     */
+    static CBigNum multi_pow_mod(const std::vector<CBigNum>& bases, const std::vector<CBigNum>& exps, const CBigNum& m);
+
     /**
     * Calculates the inverse of this element mod m.
     * i.e. i such this*i = 1 mod m
@@ -209,6 +237,52 @@ public:
     friend inline bool operator>(const CBigNum& a, const CBigNum& b);
 };
 
+/**
+ * Fixed-base modular exponentiation. The powers base^(d * 2^(WINDOW_BITS*i)) mod m are
+ * computed once, after which base^e mod m costs one modular multiplication per nonzero
+ * window of e and no squarings.
+ * The table lookups depend on the exponent, only use it with public exponents.
+ */
+class CBigNumFixedBase
+{
+public:
+    static const unsigned int WINDOW_BITS = 4;
+
+    CBigNumFixedBase() : nMaxBits(0) {}
+
+    /**
+     * Precompute the powers of a base
+     * @param baseIn the fixed base
+     * @param m the modulus
+     * @param orderIn the order of the base mod m, exponents are reduced by it (0 if unknown)
+     * @param nMaxBitsIn the longest exponent covered by the table, longer ones use CBigNum::pow_mod
+     */
+    CBigNumFixedBase(const CBigNum& baseIn, const CBigNum& m, const CBigNum& orderIn, unsigned int nMaxBitsIn);
+
+    /**
+     * modular exponentiation: base^e mod m
+     * @param e exponent
+     */
+    CBigNum pow_mod(const CBigNum& e) const;
+
+    /**
+     * modular exponentiation into an existing number: ret = base^e mod m
+     * @param ret receives the result, its storage is reused
+     * @param e exponent
+     */
+    void pow_mod_into(CBigNum& ret, const CBigNum& e) const;
+
+    bool IsNull() const { return vPowers.empty(); }
+
+private:
+    CBigNum base;
+    CBigNum modulus;
+    CBigNum order;
+    unsigned int nMaxBits;
+    //! base^(d * 2^(WINDOW_BITS*i)) mod m for the digits d in [1, 2^WINDOW_BITS) of window i
+    std::vector<CBigNum> vPowers;
+};
+
 #if defined(USE_NUM_OPENSSL)
 class CAutoBN_CTX
 {
@@ -6,6 +6,33 @@
 
 #include "bignum.h"
 
+namespace {
+/**
+ * Per thread temporaries for the in-place operations. They keep their limbs
+ * between calls, so the hot loops of the proof verifiers do not go through
+ * the allocator for every intermediate product.
+ */
+struct CBigNumScratch
+{
+    mpz_t product;
+    mpz_t exponent;
+
+    CBigNumScratch()
+    {
+        // room for the product of two 4096 bit numbers
+        mpz_init2(product, 2 * 4096);
+        mpz_init2(exponent, 4096);
+    }
+    ~CBigNumScratch()
+    {
+        mpz_clear(product);
+        mpz_clear(exponent);
+    }
+};
+
+thread_local CBigNumScratch scratch;
+}
+
 /** C++ wrapper for BIGNUM (Gmp bignum) */
 CBigNum::CBigNum()
 {
@@ -220,6 +247,18 @@ CBigNum CBigNum::mul_mod(const CBigNum& b, const CBigNum& m) const
     return ret;
 }
 
+/**
+ * in-place modular multiplication: this = (this * b) mod m
+ * @param b operand
+ * @param m modulus
+ */
+CBigNum& CBigNum::mul_mod_inplace(const CBigNum& b, const CBigNum& m)
+{
+    mpz_mul(scratch.product, bn, b.bn);
+    mpz_mod(bn, scratch.product, m.bn);
+    return *this;
+}
+
 /**
  * modular exponentiation: this^e mod n
  * @param e exponent
@@ -228,10 +267,70 @@ CBigNum CBigNum::mul_mod(const CBigNum& b, const CBigNum& m) const
 CBigNum CBigNum::pow_mod(const CBigNum& e, const CBigNum& m) const
 {
     CBigNum ret;
-    if (e > CBigNum(0) && mpz_odd_p(m.bn))
+    pow_mod_into(ret, e, m);
+    return ret;
+}
+
+/**
+ * modular exponentiation into an existing number: ret = this^e mod m
+ * @param ret receives the result
+ * @param e exponent
+ * @param m modulus
+ */
+void CBigNum::pow_mod_into(CBigNum& ret, const CBigNum& e, const CBigNum& m) const
+{
+    if (mpz_sgn(e.bn) > 0 && mpz_odd_p(m.bn))
         mpz_powm_sec (ret.bn, bn, e.bn, m.bn);
     else
         mpz_powm (ret.bn, bn, e.bn, m.bn);
+}
+
+/**
+ * simultaneous modular exponentiation: prod(bases[i]^exps[i]) mod m
+ * @param bases the bases
+ * @param exps the exponents, one per base
+ * @param m modulus
+ */
+CBigNum CBigNum::multi_pow_mod(const std::vector<CBigNum>& bases, const std::vector<CBigNum>& exps, const CBigNum& m)
+{
+    if (bases.size() != exps.size())
+        throw bignum_error("CBigNum::multi_pow_mod : number of bases and exponents differ");
+
+    // Per base, a table of base^1 .. base^(2^WINDOW_BITS - 1)
+    const unsigned int WINDOW_BITS = 4;
+    const unsigned int nDigits = (1 << WINDOW_BITS) - 1;
+    std::vector<CBigNum> vTable(bases.size() * nDigits);
+    std::vector<CBigNum> vExps(exps.size());
+    size_t nBits = 0;
+    for (unsigned int i = 0; i < bases.size(); i++) {
+        // g^-x = (g^-1)^x
+        CBigNum* row = &vTable[i * nDigits];
+        if (mpz_sgn(exps[i].bn) < 0)
+            mpz_invert(row[0].bn, bases[i].bn, m.bn);
+        else
+            mpz_mod(row[0].bn, bases[i].bn, m.bn);
+        for (unsigned int d = 1; d < nDigits; d++) {
+            mpz_mul(row[d].bn, row[d - 1].bn, row[0].bn);
+            mpz_mod(row[d].bn, row[d].bn, m.bn);
+        }
+        mpz_abs(vExps[i].bn, exps[i].bn);
+        nBits = std::max(nBits, mpz_sizeinbase(vExps[i].bn, 2));
+    }
+
+    CBigNum ret(1);
+    for (size_t w = (nBits + WINDOW_BITS - 1) / WINDOW_BITS; w-- > 0;) {
+        for (unsigned int j = 0; j < WINDOW_BITS && mpz_cmp_ui(ret.bn, 1) != 0; j++) {
+            mpz_mul(scratch.product, ret.bn, ret.bn);
+            mpz_mod(ret.bn, scratch.product, m.bn);
+        }
+        for (unsigned int i = 0; i < vExps.size(); i++) {
+            unsigned int d = 0;
+            for (unsigned int j = 0; j < WINDOW_BITS; j++)
+                d |= mpz_tstbit(vExps[i].bn, w * WINDOW_BITS + j) << j;
+            if (d)
+                ret.mul_mod_inplace(vTable[i * nDigits + d - 1], m);
+        }
+    }
     return ret;
 }
 
@@ -339,3 +438,76 @@ CBigNum& CBigNum::operator--()
     mpz_sub(bn, bn, CBigNum(1).bn);
     return *this;
 }
+
+CBigNumFixedBase::CBigNumFixedBase(const CBigNum& baseIn, const CBigNum& m, const CBigNum& orderIn, unsigned int nMaxBitsIn) :
+    base(baseIn), modulus(m), order(orderIn), nMaxBits(nMaxBitsIn)
+{
+    const unsigned int nDigits = (1 << WINDOW_BITS) - 1;
+    const unsigned int nWindows = (nMaxBits + WINDOW_BITS - 1) / WINDOW_BITS;
+    vPowers.resize(nWindows * nDigits);
+
+    // windowBase = base^(2^(WINDOW_BITS*i)) mod m
+    CBigNum windowBase;
+    mpz_mod(windowBase.bn, base.bn, modulus.bn);
+    for (unsigned int i = 0; i < nWindows; i++) {
+        CBigNum* row = &vPowers[i * nDigits];
+        row[0] = windowBase;
+        for (unsigned int d = 1; d < nDigits; d++) {
+            mpz_mul(row[d].bn, row[d - 1].bn, windowBase.bn);
+            mpz_mod(row[d].bn, row[d].bn, modulus.bn);
+        }
+        mpz_mul(windowBase.bn, row[nDigits - 1].bn, windowBase.bn);
+        mpz_mod(windowBase.bn, windowBase.bn, modulus.bn);
+    }
+}
+
+/**
+ * modular exponentiation: base^e mod m
+ * @param e exponent
+ */
+CBigNum CBigNumFixedBase::pow_mod(const CBigNum& e) const
+{
+    CBigNum ret;
+    pow_mod_into(ret, e);
+    return ret;
+}
+
+/**
+ * modular exponentiation into an existing number: ret = base^e mod m
+ * @param ret receives the result
+ * @param e exponent
+ */
+void CBigNumFixedBase::pow_mod_into(CBigNum& ret, const CBigNum& e) const
+{
+    if (IsNull())
+        throw bignum_error("CBigNumFixedBase::pow_mod : no precomputed powers");
+
+    // ret may be e, so take what is needed from it first
+    const bool fInvert = mpz_sgn(e.bn) < 0 && mpz_sgn(order.bn) <= 0;
+    if (mpz_sgn(order.bn) > 0)
+        mpz_mod(scratch.exponent, e.bn, order.bn);
+    else
+        mpz_abs(scratch.exponent, e.bn);
+
+    const size_t nBits = mpz_sizeinbase(scratch.exponent, 2);
+    if (nBits > nMaxBits) {
+        base.pow_mod_into(ret, e, modulus);
+        return;
+    }
+
+    const unsigned int nDigits = (1 << WINDOW_BITS) - 1;
+    mpz_set_ui(ret.bn, 1);
+    for (size_t i = 0; i * WINDOW_BITS < nBits; i++) {
+        unsigned int d = 0;
+        for (unsigned int j = 0; j < WINDOW_BITS; j++)
+            d |= mpz_tstbit(scratch.exponent, i * WINDOW_BITS + j) << j;
+        if (d) {
+            mpz_mul(scratch.product, ret.bn, vPowers[i * nDigits + d - 1].bn);
+            mpz_mod(ret.bn, scratch.product, modulus.bn);
+        }
+    }
+
+    // Unknown order: g^-x = (g^x)^-1
+    if (fInvert)
+        mpz_invert(ret.bn, ret.bn, modulus.bn);
+}
@@ -351,6 +351,19 @@ CBigNum CBigNum::mul_mod(const CBigNum& b, const CBigNum& m) const
     return ret;
 }
 
+/**
+ * in-place modular multiplication: this = (this * b) mod m
+ * @param b operand
+ * @param m modulus
+ */
+CBigNum& CBigNum::mul_mod_inplace(const CBigNum& b, const CBigNum& m)
+{
+    CAutoBN_CTX pctx;
+    if (!BN_mod_mul(bn, bn, b.bn, m.bn, pctx))
+        throw bignum_error("CBigNum::mul_mod_inplace : BN_mod_mul failed");
+    return *this;
+}
+
 /**
  * modular exponentiation: this^e mod n
  * @param e exponent
@@ -358,8 +371,20 @@ CBigNum CBigNum::mul_mod(const CBigNum& b, const CBigNum& m) const
  */
 CBigNum CBigNum::pow_mod(const CBigNum& e, const CBigNum& m) const
 {
-    CAutoBN_CTX pctx;
     CBigNum ret;
+    pow_mod_into(ret, e, m);
+    return ret;
+}
+
+/**
+ * modular exponentiation into an existing number: ret = this^e mod m
+ * @param ret receives the result
+ * @param e exponent
+ * @param m modulus
+ */
+void CBigNum::pow_mod_into(CBigNum& ret, const CBigNum& e, const CBigNum& m) const
+{
+    CAutoBN_CTX pctx;
     if( e < 0){
         // g^-x = (g^-1)^x
         CBigNum inv = this->inverse(m);
@@ -369,7 +394,54 @@ CBigNum CBigNum::pow_mod(const CBigNum& e, const CBigNum& m) const
     }else
         if (!BN_mod_exp(ret.bn, bn, e.bn, m.bn, pctx))
             throw bignum_error("CBigNum::pow_mod : BN_mod_exp failed");
+}
 
+/**
+ * simultaneous modular exponentiation: prod(bases[i]^exps[i]) mod m
+ * @param bases the bases
+ * @param exps the exponents, one per base
+ * @param m modulus
+ */
+CBigNum CBigNum::multi_pow_mod(const std::vector<CBigNum>& bases, const std::vector<CBigNum>& exps, const CBigNum& m)
+{
+    if (bases.size() != exps.size())
+        throw bignum_error("CBigNum::multi_pow_mod : number of bases and exponents differ");
+
+    // Per base, a table of base^1 .. base^(2^WINDOW_BITS - 1)
+    const unsigned int WINDOW_BITS = 4;
+    const unsigned int nDigits = (1 << WINDOW_BITS) - 1;
+    CAutoBN_CTX pctx;
+    std::vector<CBigNum> vTable(bases.size() * nDigits);
+    std::vector<CBigNum> vExps(exps);
+    int nBits = 0;
+    for (unsigned int i = 0; i < bases.size(); i++) {
+        // g^-x = (g^-1)^x
+        CBigNum* row = &vTable[i * nDigits];
+        if (BN_is_negative(vExps[i].bn)) {
+            row[0] = bases[i].inverse(m);
+            BN_set_negative(vExps[i].bn, 0);
+        } else if (!BN_nnmod(row[0].bn, bases[i].bn, m.bn, pctx)) {
+            throw bignum_error("CBigNum::multi_pow_mod : BN_nnmod failed");
+        }
+        for (unsigned int d = 1; d < nDigits; d++)
+            if (!BN_mod_mul(row[d].bn, row[d - 1].bn, row[0].bn, m.bn, pctx))
+                throw bignum_error("CBigNum::multi_pow_mod : BN_mod_mul failed");
+        nBits = std::max(nBits, BN_num_bits(vExps[i].bn));
+    }
+
+    CBigNum ret(1);
+    for (int w = (nBits + WINDOW_BITS - 1) / WINDOW_BITS; w-- > 0;) {
+        for (unsigned int j = 0; j < WINDOW_BITS && !BN_is_one(ret.bn); j++)
+            if (!BN_mod_sqr(ret.bn, ret.bn, m.bn, pctx))
+                throw bignum_error("CBigNum::multi_pow_mod : BN_mod_sqr failed");
+        for (unsigned int i = 0; i < vExps.size(); i++) {
+            unsigned int d = 0;
+            for (unsigned int j = 0; j < WINDOW_BITS; j++)
+                d |= BN_is_bit_set(vExps[i].bn, w * WINDOW_BITS + j) << j;
+            if (d && !BN_mod_mul(ret.bn, ret.bn, vTable[i * nDigits + d - 1].bn, m.bn, pctx))
+                throw bignum_error("CBigNum::multi_pow_mod : BN_mod_mul failed");
+        }
+    }
     return ret;
 }
 
@@ -506,3 +578,82 @@ CBigNum& CBigNum::operator--()
     bn = r.bn;
     return *this;
 }
+
+CBigNumFixedBase::CBigNumFixedBase(const CBigNum& baseIn, const CBigNum& m, const CBigNum& orderIn, unsigned int nMaxBitsIn) :
+    base(baseIn), modulus(m), order(orderIn), nMaxBits(nMaxBitsIn)
+{
+    const unsigned int nDigits = (1 << WINDOW_BITS) - 1;
+    const unsigned int nWindows = (nMaxBits + WINDOW_BITS - 1) / WINDOW_BITS;
+    vPowers.resize(nWindows * nDigits);
+
+    // windowBase = base^(2^(WINDOW_BITS*i)) mod m
+    CAutoBN_CTX pctx;
+    CBigNum windowBase;
+    if (!BN_nnmod(windowBase.bn, base.bn, modulus.bn, pctx))
+        throw bignum_error("CBigNumFixedBase : BN_nnmod failed");
+    for (unsigned int i = 0; i < nWindows; i++) {
+        CBigNum* row = &vPowers[i * nDigits];
+        row[0] = windowBase;
+        for (unsigned int d = 1; d < nDigits; d++) {
+            if (!BN_mod_mul(row[d].bn, row[d - 1].bn, windowBase.bn, modulus.bn, pctx))
+                throw bignum_error("CBigNumFixedBase : BN_mod_mul failed");
+        }
+        if (!BN_mod_mul(windowBase.bn, row[nDigits - 1].bn, windowBase.bn, modulus.bn, pctx))
+            throw bignum_error("CBigNumFixedBase : BN_mod_mul failed");
+    }
+}
+
+/**
+ * modular exponentiation: base^e mod m
+ * @param e exponent
+ */
+CBigNum CBigNumFixedBase::pow_mod(const CBigNum& e) const
+{
+    CBigNum ret;
+    pow_mod_into(ret, e);
+    return ret;
+}
+
+/**
+ * modular exponentiation into an existing number: ret = base^e mod m
+ * @param ret receives the result
+ * @param e exponent
+ */
+void CBigNumFixedBase::pow_mod_into(CBigNum& ret, const CBigNum& e) const
+{
+    if (IsNull())
+        throw bignum_error("CBigNumFixedBase::pow_mod : no precomputed powers");
+
+    // ret may be e, so take what is needed from it first
+    const bool fInvert = BN_is_negative(e.bn) && BN_cmp(order.bn, CBigNum(0).bn) <= 0;
+    CAutoBN_CTX pctx;
+    CBigNum exp;
+    if (BN_cmp(order.bn, CBigNum(0).bn) > 0) {
+        if (!BN_nnmod(exp.bn, e.bn, order.bn, pctx))
+            throw bignum_error("CBigNumFixedBase::pow_mod : BN_nnmod failed");
+    } else {
+        exp = e;
+        BN_set_negative(exp.bn, 0);
+    }
+
+    if ((unsigned int)BN_num_bits(exp.bn) > nMaxBits) {
+        base.pow_mod_into(ret, e, modulus);
+        return;
+    }
+
+    const unsigned int nDigits = (1 << WINDOW_BITS) - 1;
+    const int nBits = BN_num_bits(exp.bn);
+    if (!BN_one(ret.bn))
+        throw bignum_error("CBigNumFixedBase::pow_mod : BN_one failed");
+    for (int i = 0; i * (int)WINDOW_BITS < nBits; i++) {
+        unsigned int d = 0;
+        for (unsigned int j = 0; j < WINDOW_BITS; j++)
+            d |= BN_is_bit_set(exp.bn, i * WINDOW_BITS + j) << j;
+        if (d && !BN_mod_mul(ret.bn, ret.bn, vPowers[i * nDigits + d - 1].bn, modulus.bn, pctx))
+            throw bignum_error("CBigNumFixedBase::pow_mod : BN_mod_mul failed");
+    }
+
+    // Unknown order: g^-x = (g^x)^-1
+    if (fInvert && !BN_mod_inverse(ret.bn, ret.bn, modulus.bn, pctx))
+        throw bignum_error("CBigNumFixedBase::pow_mod : BN_mod_inverse failed");
+}
@@ -12,97 +12,130 @@
 void CLightWorker::ThreadLightzNATIVESimplified() {
     RenameThread("nativecoin-light-thread");
     isWorkerRunning = true;
+    std::vector<CGenWit> vWork;
     while (true) {
         try {
 
-            // Take a breath between requests.. TODO: Add processor usage check here
-            MilliSleep(2000);
-
-            // TODO: Future: join several similar requests into one calculation if the filter and denom match..
-            CGenWit genWit = requestsQueue.pop();
-            LogPrintf("%s pop work for %s \n\n", "nativecoin-light-thread", genWit.toString());
-
-            libzerocoin::ZerocoinParams *params = Params().Zerocoin_Params(false);
-            CBlockIndex *pIndex = chainActive[genWit.getStartingHeight()];
-            if (!pIndex) {
-                // Rejects only the failed height
-                rejectWork(genWit, genWit.getStartingHeight(), NON_DETERMINED);
-            } else {
-                LogPrintf("%s calculating work for %s \n\n", "nativecoin-light-thread", genWit.toString());
-                int blockHeight = pIndex->nHeight;
-                if (blockHeight >= Params().Zerocoin_Block_V2_Start()) {
-
-                    // TODO: The protocol actually doesn't care about the Accumulator..
-                    libzerocoin::Accumulator accumulator(params, genWit.getDen(), genWit.getAccWitValue());
-                    libzerocoin::PublicCoin temp(params);
-                    libzerocoin::AccumulatorWitness witness(params, accumulator, temp);
-                    string strFailReason = "";
-                    int nMintsAdded = 0;
-                    CZerocoinSpendReceipt receipt;
-
-                    list<CBigNum> ret;
-                    int heightStop;
-
-                    bool res;
-                    try {
-
-                        res = CalculateAccumulatorWitnessFor(
-                                params,
-                                blockHeight,
-                                COMP_MAX_AMOUNT,
-                                genWit.getDen(),
-                                genWit.getFilter(),
-                                accumulator,
-                                witness,
-                                nMintsAdded,
-                                strFailReason,
-                                ret,
-                                heightStop
-                        );
-
-                    } catch (NotEnoughMintsException e) {
-                        LogPrintStr(std::string("ThreadLightzNATIVESimplified: ") + e.message + "\n");
-                        rejectWork(genWit, blockHeight, NOT_ENOUGH_MINTS);
-                        continue;
-                    }
-
-                    if (!res) {
-                        // TODO: Check if the GenerateAccumulatorWitnessFor can fail for node's fault or it's just because the peer sent an illegal request..
-                        rejectWork(genWit, blockHeight, NON_DETERMINED);
-                    } else {
-                        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-                        ss.reserve(ret.size() * 32);
-
-                        ss << genWit.getRequestNum();
-                        ss << accumulator.getValue(); // TODO: ---> this accumulator value is not necessary. The light node should get it using the other message..
-                        ss << witness.getValue();
-                        uint32_t size = ret.size();
-                        ss << size;
-                        for (CBigNum bnValue : ret) {
-                            ss << bnValue;
-                        }
-                        ss << heightStop;
-                        if (genWit.getPfrom()) {
-                            LogPrintf("%s pushing message to %s \n", "nativecoin-light-thread", genWit.getPfrom()->addrName);
-                            genWit.getPfrom()->PushMessage("pubcoins", ss);
-                        } else
-                            LogPrintf("%s NOT pushing message to %s \n", "nativecoin-light-thread", genWit.getPfrom()->addrName);
-                    }
-                } else {
-                    // Rejects only the failed height
-                    rejectWork(genWit, blockHeight, NON_DETERMINED);
-                }
-            }
+            boost::this_thread::interruption_point();
+
+            vWork.clear();
+            if (!popWork(vWork, std::chrono::milliseconds(500)))
+                continue;
+
+            processWork(vWork);
+        } catch (const boost::thread_interrupted&) {
+            for (CGenWit& wit : vWork)
+                releasePeerRequest(wit);
+            break;
         } catch (std::exception& e) {
-            //std::cout << "exception in light loop, closing it. " << e.what() << std::endl;
+            // Keep the worker, the requests of the failed calculation are answered so their peers get their slots back
             PrintExceptionContinue(&e, "lightzNATIVEthread");
-            break;
+            rejectUnanswered(vWork);
         }
     }
 
 
 }
 
+bool CLightWorker::popWork(std::vector<CGenWit>& vWork, std::chrono::milliseconds timeout) {
+    CGenWit genWit;
+    if (!requestsQueue.pop_for(genWit, timeout))
+        return false;
+
+    // Join the queued requests with the same denom and starting height into this calculation, they only differ on the filter
+    vWork.push_back(genWit);
+    requestsQueue.drain_if(vWork, [&genWit](const CGenWit& wit) {
+        return wit.getDen() == genWit.getDen() && wit.getStartingHeight() == genWit.getStartingHeight();
+    });
+    LogPrintf("%s pop work for %s, joined %d similar requests \n\n", "nativecoin-light-thread", genWit.toString(), vWork.size() - 1);
+    return true;
+}
+
+void CLightWorker::processWork(std::vector<CGenWit>& vWork) {
+    const CGenWit& genWit = vWork.front();
+    libzerocoin::ZerocoinParams *params = Params().Zerocoin_Params(false);
+    CBlockIndex *pIndex = chainActive[genWit.getStartingHeight()];
+    if (!pIndex) {
+        // Rejects only the failed height
+        for (CGenWit& wit : vWork)
+            rejectWork(wit, wit.getStartingHeight(), NON_DETERMINED);
+        return;
+    }
+
+    LogPrintf("%s calculating work for %s \n\n", "nativecoin-light-thread", genWit.toString());
+    int blockHeight = pIndex->nHeight;
+    if (blockHeight < Params().Zerocoin_Block_V2_Start()) {
+        // Rejects only the failed height
+        for (CGenWit& wit : vWork)
+            rejectWork(wit, blockHeight, NON_DETERMINED);
+        return;
+    }
+
+    // TODO: The protocol actually doesn't care about the Accumulator..
+    libzerocoin::Accumulator accumulator(params, genWit.getDen(), genWit.getAccWitValue());
+    std::vector<LightWitnessRequest> vRequests;
+    for (const CGenWit& wit : vWork)
+        vRequests.emplace_back(wit.getFilter(), wit.getAccWitValue());
+    string strFailReason = "";
+    int nMintsAdded = 0;
+    int heightStop;
+
+    bool res = CalculateAccumulatorWitnessFor(
+            params,
+            blockHeight,
+            COMP_MAX_AMOUNT,
+            genWit.getDen(),
+            vRequests,
+            accumulator,
+            nMintsAdded,
+            strFailReason,
+            heightStop
+    );
+
+    for (unsigned int i = 0; i < vWork.size(); i++) {
+        CGenWit& wit = vWork[i];
+        const LightWitnessRequest& request = vRequests[i];
+        if (!res) {
+            // TODO: Check if the GenerateAccumulatorWitnessFor can fail for node's fault or it's just because the peer sent an illegal request..
+            rejectWork(wit, blockHeight, NON_DETERMINED);
+            continue;
+        }
+
+        // A certain amount of accumulated coins are required
+        if (request.nMintsAdded < Params().Zerocoin_RequiredAccumulation()) {
+            LogPrintf("ThreadLightzNATIVESimplified: Less than %d mints added for %s\n", Params().Zerocoin_RequiredAccumulation(), wit.toString());
+            rejectWork(wit, blockHeight, NOT_ENOUGH_MINTS);
+            continue;
+        }
+
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        ss.reserve(request.listFilteredCoins.size() * 32);
+
+        ss << wit.getRequestNum();
+        ss << request.bnAccumulatorValue; // TODO: ---> this accumulator value is not necessary. The light node should get it using the other message..
+        ss << request.bnWitnessValue;
+        uint32_t size = request.listFilteredCoins.size();
+        ss << size;
+        for (const CBigNum& bnValue : request.listFilteredCoins) {
+            ss << bnValue;
+        }
+        ss << heightStop;
+        if (wit.getPfrom()) {
+            LogPrintf("%s pushing message to %s \n", "nativecoin-light-thread", wit.getPfrom()->addrName);
+            wit.getPfrom()->PushMessage("pubcoins", ss);
+        } else
+            LogPrintf("%s NOT pushing message, the request has no peer \n", "nativecoin-light-thread");
+        releasePeerRequest(wit);
+    }
+}
+
+void CLightWorker::rejectUnanswered(std::vector<CGenWit>& vWork) {
+    for (CGenWit& wit : vWork) {
+        if (wit.getPfrom())
+            rejectWork(wit, wit.getStartingHeight(), NON_DETERMINED);
+    }
+}
+
 // TODO: Think more the peer misbehaving policy..
 void CLightWorker::rejectWork(CGenWit& wit, int blockHeight, uint32_t errorNumber) {
     if (wit.getStartingHeight() == blockHeight){
@@ -110,8 +143,44 @@ void CLightWorker::rejectWork(CGenWit& wit, int blockHeight, uint32_t errorNumbe
         CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
         ss << wit.getRequestNum();
         ss << errorNumber;
-        wit.getPfrom()->PushMessage("pubcoins", ss);
+        if (wit.getPfrom())
+            wit.getPfrom()->PushMessage("pubcoins", ss);
+        releasePeerRequest(wit);
+    } else if (!requestsQueue.try_push(wit)) {
+        LogPrintf("%s queue is full, dropping work %s\n", "nativecoin-light-thread", wit.toString());
+        releasePeerRequest(wit);
     } else {
-        requestsQueue.push(wit);
+        // The queue has it again, this copy is done
+        wit.setPfrom(nullptr);
     }
 }
+
+bool CLightWorker::reservePeerRequest(const CGenWit& wit) {
+    if (!wit.getPfrom())
+        return true;
+    std::lock_guard<std::mutex> lock(cs_peerRequests);
+    int& nRequests = mapPeerRequests[wit.getPfrom()->GetId()];
+    if (nRequests >= MAX_LIGHT_REQUESTS_PER_PEER)
+        return false;
+    nRequests++;
+    return true;
+}
+
+void CLightWorker::releasePeerRequest(CGenWit& wit) {
+    if (!wit.getPfrom())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(cs_peerRequests);
+        auto it = mapPeerRequests.find(wit.getPfrom()->GetId());
+        if (it != mapPeerRequests.end() && --it->second <= 0)
+            mapPeerRequests.erase(it);
+    }
+    // Released once: the request is answered and no longer holds a slot of its peer
+    wit.setPfrom(nullptr);
+}
+
+int CLightWorker::getPeerRequests(NodeId id) {
+    std::lock_guard<std::mutex> lock(cs_peerRequests);
+    auto it = mapPeerRequests.find(id);
+    return it == mapPeerRequests.end() ? 0 : it->second;
+}
@@ -8,9 +8,11 @@
 #define nativecoin_LIGHTzNATIVETHREAD_H
 
 #include <atomic>
+#include <map>
+#include <mutex>
 #include "genwit.h"
 #include "zNATIVE/accumulators.h"
-#include "concurrentqueue.h"
+#include "boundedqueue.h"
 #include "chainparams.h"
 #include <boost/function.hpp>
 #include <boost/thread.hpp>
@@ -18,21 +20,30 @@
 extern CChain chainActive;
 // Max amount of computation for a single request
 const int COMP_MAX_AMOUNT = 60 * 24 * 60;
+// Default number of threads serving witness requests
+const int DEFAULT_LIGHT_WORKERS = 2;
+// Max amount of requests a single peer can have queued or in calculation
+const int MAX_LIGHT_REQUESTS_PER_PEER = 10;
+// Max amount of requests waiting for a worker, new ones are rejected
+const size_t MAX_LIGHT_QUEUE_SIZE = 500;
 
 
 /****** Thread ********/
 
 class CLightWorker{
 
-private:
+protected:
 
-    concurrentqueue<CGenWit> requestsQueue;
+    CBoundedQueue<CGenWit> requestsQueue;
     std::atomic<bool> isWorkerRunning;
-    boost::thread threadIns;
+    boost::thread_group threadsIns;
+
+    std::mutex cs_peerRequests;
+    std::map<NodeId, int> mapPeerRequests;
 
 public:
 
-    CLightWorker() {
+    CLightWorker() : requestsQueue(MAX_LIGHT_QUEUE_SIZE) {
         isWorkerRunning = false;
     }
 
@@ -46,26 +57,62 @@ public:
             LogPrintf("%s not running trying to add wit work \n", "nativecoin-light-thread");
             return false;
         }
-        requestsQueue.push(wit);
+        if (!reservePeerRequest(wit)) {
+            LogPrint("zNATIVE", "%s peer=%d is over its quota of %d requests \n", "nativecoin-light-thread", wit.getPfrom()->GetId(), MAX_LIGHT_REQUESTS_PER_PEER);
+            return false;
+        }
+        if (!requestsQueue.try_push(wit)) {
+            LogPrint("zNATIVE", "%s queue is full, rejecting work \n", "nativecoin-light-thread");
+            releasePeerRequest(wit);
+            return false;
+        }
         return true;
     }
 
     void StartLightzNATIVEThread(boost::thread_group& threadGroup) {
-        LogPrintf("%s thread start\n", "nativecoin-light-thread");
-        threadIns = boost::thread(boost::bind(&CLightWorker::ThreadLightzNATIVESimplified, this));
+        int nWorkers = std::max((int)GetArg("-lightworkers", DEFAULT_LIGHT_WORKERS), 1);
+        LogPrintf("%s thread start, %d workers\n", "nativecoin-light-thread", nWorkers);
+        for (int i = 0; i < nWorkers; i++)
+            threadsIns.create_thread(boost::bind(&CLightWorker::ThreadLightzNATIVESimplified, this));
     }
 
     void StopLightzNATIVEThread() {
-        threadIns.interrupt();
-        LogPrintf("%s thread interrupted\n", "nativecoin-light-thread");
+        requestsQueue.close();
+        threadsIns.interrupt_all();
+        threadsIns.join_all();
+        isWorkerRunning = false;
+        LogPrintf("%s thread stopped\n", "nativecoin-light-thread");
+    }
+
+    CBoundedQueue<CGenWit>::Stats GetQueueStats() const {
+        return requestsQueue.GetStats();
     }
 
-private:
+    bool IsRunning() const {
+        return isWorkerRunning;
+    }
+
+protected:
 
     void ThreadLightzNATIVESimplified();
 
+    // Takes the next request and the queued ones with the same denom and starting height, false if none came in time
+    bool popWork(std::vector<CGenWit>& vWork, std::chrono::milliseconds timeout);
+
+    // Calculates the witnesses of the popped requests and answers each of them
+    void processWork(std::vector<CGenWit>& vWork);
+
+    // Rejects the requests that were not answered yet, an answered request no longer has a peer
+    void rejectUnanswered(std::vector<CGenWit>& vWork);
+
     void rejectWork(CGenWit& wit, int blockHeight, uint32_t errorNumber);
 
+    bool reservePeerRequest(const CGenWit& wit);
+
+    void releasePeerRequest(CGenWit& wit);
+
+    int getPeerRequests(NodeId id);
+
 };
 
 #endif //nativecoin_LIGHTzNATIVETHREAD_H
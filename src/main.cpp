@@ -10,6 +10,7 @@
 
 #include "zNATIVE/accumulators.h"
 #include "zNATIVE/accumulatormap.h"
+#include "zNATIVE/spendcache.h"
 #include "addrman.h"
 #include "alert.h"
 #include "blocksignature.h"
@@ -72,6 +73,7 @@ int64_t nTimeBestReceived = 0;
 CWaitableCriticalSection csBestBlock;
 CConditionVariable cvBlockChange;
 int nScriptCheckThreads = 0;
+int nZerocoinSpendCheckThreads = 0;
 bool fImporting = false;
 bool fReindex = false;
 bool fTxIndex = true;
@@ -102,6 +104,10 @@ map<uint256, set<uint256> > mapOrphanTransactionsByPrev;
 map<uint256, int64_t> mapRejectedBlocks;
 map<uint256, int64_t> mapZerocoinspends; //txid, time received
 
+/** Progress of ThreadVerifyBlockIndexHashes() */
+CCriticalSection cs_blockIndexVerify;
+CBlockIndexVerifyStatus blockIndexVerifyStatus;
+
 /***/
 CLightWorker lightWorker;
 
@@ -1043,7 +1049,19 @@ bool ContextualCheckZerocoinSpendNoSerialCheck(const CTransaction& tx, const Coi
 }
 
 
-bool CheckZerocoinSpend(const CTransaction& tx, bool fVerifySignature, CValidationState& state, bool fFakeSerialAttack)
+bool CZerocoinSpendCheck::operator()()
+{
+    try {
+        Accumulator accumulator(params, pspend->getDenomination(), bnAccumulatorValue);
+        if (!VerifyZerocoinSpendCached(*pspend, accumulator, fVerifyParams))
+            return ::error("CZerocoinSpendCheck(): zerocoin spend with serial %s did not verify", pspend->getCoinSerialNumber().GetHex());
+    } catch (const std::exception& e) {
+        return ::error("CZerocoinSpendCheck(): %s", e.what());
+    }
+    return true;
+}
+
+bool CheckZerocoinSpend(const CTransaction& tx, bool fVerifySignature, CValidationState& state, bool fFakeSerialAttack, std::vector<CZerocoinSpendCheck>* pvChecks)
 {
     //max needed non-mint outputs should be 2 - one for redemption address and a possible 2nd for change
     if (tx.vout.size() > 2) {
@@ -1098,12 +1116,16 @@ bool CheckZerocoinSpend(const CTransaction& tx, bool fVerifySignature, CValidati
                 return state.DoS(100, error("%s: Zerocoinspend could not find accumulator associated with checksum %s", __func__, HexStr(BEGIN(nChecksum), END(nChecksum))));
             }
 
-            Accumulator accumulator(Params().Zerocoin_Params(chainActive.Height() < Params().Zerocoin_Block_V2_Start()),
-                                    newSpend.getDenomination(), bnAccumulatorValue);
+            CZerocoinSpendCheck check(newSpend, Params().Zerocoin_Params(chainActive.Height() < Params().Zerocoin_Block_V2_Start()),
+                                      bnAccumulatorValue, !fFakeSerialAttack);
 
-            //Check that the coin has been accumulated
-            if(!newSpend.Verify(accumulator, !fFakeSerialAttack))
-                    return state.DoS(100, error("CheckZerocoinSpend(): zerocoin spend did not verify"));
+            //Check that the coin has been accumulated, or defer the proof verification to the caller
+            if (pvChecks) {
+                pvChecks->push_back(CZerocoinSpendCheck());
+                check.swap(pvChecks->back());
+            } else if (!check()) {
+                return state.DoS(100, error("CheckZerocoinSpend(): zerocoin spend did not verify"));
+            }
         }
 
         if (serials.count(newSpend.getCoinSerialNumber()))
@@ -1123,7 +1145,7 @@ bool CheckZerocoinSpend(const CTransaction& tx, bool fVerifySignature, CValidati
     return fValidated;
 }
 
-bool CheckTransaction(const CTransaction& tx, bool fZerocoinActive, bool fRejectBadUTXO, CValidationState& state, bool fFakeSerialAttack)
+bool CheckTransaction(const CTransaction& tx, bool fZerocoinActive, bool fRejectBadUTXO, CValidationState& state, bool fFakeSerialAttack, std::vector<CZerocoinSpendCheck>* pvZerocoinChecks)
 {
     // Basic checks that don't depend on any context
     if (tx.vin.empty())
@@ -1179,7 +1201,7 @@ bool CheckTransaction(const CTransaction& tx, bool fZerocoinActive, bool fReject
 
             // Do not require signature verification if this is initial sync and a block over 24 hours old
             bool fVerifySignature = !IsInitialBlockDownload() && (GetTime() - chainActive.Tip()->GetBlockTime() < (60*60*24));
-            if (!CheckZerocoinSpend(tx, fVerifySignature, state, fFakeSerialAttack))
+            if (!CheckZerocoinSpend(tx, fVerifySignature, state, fFakeSerialAttack, pvZerocoinChecks))
                 return state.DoS(100, error("CheckTransaction() : invalid zerocoin spend"));
         }
     }
@@ -2575,6 +2597,11 @@ bool DisconnectBlock(CBlock& block, CValidationState& state, CBlockIndex* pindex
     if (blockUndo.vtxundo.size() + 1 != block.vtx.size())
         return error("DisconnectBlock() : block and undo data inconsistent");
 
+    if (pindex->nHeight >= Params().Zerocoin_StartHeight() && !zerocoinDB->EraseBlockPubcoins(pindex->GetBlockHash()))
+        return error("DisconnectBlock() : failed to erase the pubcoin index of the block");
+    if (pindex->nHeight >= Params().Zerocoin_StartHeight() && !zerocoinDB->EraseBlockSerials(pindex->GetBlockHash()))
+        return error("DisconnectBlock() : failed to erase the serial index of the block");
+
     // undo transactions in reverse order
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
         const CTransaction& tx = block.vtx[i];
@@ -2727,6 +2754,18 @@ void ThreadScriptCheck()
     scriptcheckqueue.Thread();
 }
 
+static CCheckQueue<CZerocoinSpendCheck> zerocoinspendcheckqueue(4);
+// CCheckQueueControl allows a single master per queue, but CheckBlock is also
+// reached from threads that do not hold cs_main. Whoever can't get the queue
+// verifies its spends inline.
+static boost::mutex cs_zerocoinspendcheckqueue;
+
+void ThreadZerocoinSpendCheck()
+{
+    RenameThread("nativecoin-zcspendch");
+    zerocoinspendcheckqueue.Thread();
+}
+
 void AddWrappedSerialsInflation()
 {
     CBlockIndex* pindex = chainActive[Params().Zerocoin_Block_EndFakeSerial()];
@@ -3352,6 +3391,17 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     if (!zerocoinDB->WriteCoinSpendBatch(vSpends)) return state.Abort(("Failed to record coin serials to database"));
     if (!zerocoinDB->WriteCoinMintBatch(vMints)) return state.Abort(("Failed to record new mints to database"));
 
+    // Index the pubcoins of this block so the accumulators can be updated without reading it again
+    if (pindex->nHeight >= Params().Zerocoin_StartHeight()) {
+        std::vector<CBlockPubcoin> vPubcoins;
+        if (!BlockToPubcoinIndex(block, vPubcoins) || !zerocoinDB->WriteBlockPubcoins(pindex->GetBlockHash(), vPubcoins))
+            return state.Abort(("Failed to record the pubcoins of the block to database"));
+
+        std::vector<CBlockSerial> vSerials;
+        if (!BlockToSerialIndex(block, vSerials) || !zerocoinDB->WriteBlockSerials(pindex->GetBlockHash(), vSerials))
+            return state.Abort(("Failed to record the serials of the block to database"));
+    }
+
     //Record accumulator checksums
     DatabaseChecksums(mapAccumulators);
 
@@ -4228,7 +4278,7 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
     // Check the merkle root.
     if (fCheckMerkleRoot) {
         bool mutated;
-        uint256 hashMerkleRoot2 = block.BuildMerkleTree(&mutated);
+        uint256 hashMerkleRoot2 = block.GetMerkleRoot(&mutated);
         if (block.hashMerkleRoot != hashMerkleRoot2)
             return state.DoS(100, error("CheckBlock() : hashMerkleRoot mismatch"),
                 REJECT_INVALID, "bad-txnmrklroot", true);
@@ -4327,6 +4377,7 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
     // Check transactions
     bool fZerocoinActive = block.GetBlockTime() > Params().Zerocoin_StartTime();
     vector<CBigNum> vBlockSerials;
+    vector<CZerocoinSpendCheck> vZerocoinChecks;
     // TODO: Check if this is ok... blockHeight is always the tip or should we look for the prevHash and get the height?
     int blockHeight = chainActive.Height() + 1;
     for (const CTransaction& tx : block.vtx) {
@@ -4335,7 +4386,8 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
                 fZerocoinActive,
                 blockHeight >= Params().Zerocoin_Block_EnforceSerialRange(),
                 state,
-                isBlockBetweenFakeSerialAttackRange(blockHeight)
+                isBlockBetweenFakeSerialAttackRange(blockHeight),
+                nZerocoinSpendCheckThreads ? &vZerocoinChecks : NULL
         ))
             return error("CheckBlock() : CheckTransaction failed");
 
@@ -4353,6 +4405,27 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
         }
     }
 
+    // Verify the proofs of all the zerocoin spends in the block at once
+    if (!vZerocoinChecks.empty()) {
+        boost::unique_lock<boost::mutex> lock(cs_zerocoinspendcheckqueue, boost::defer_lock);
+        bool fValid = true;
+        if (lock.try_lock()) {
+            CCheckQueueControl<CZerocoinSpendCheck> control(&zerocoinspendcheckqueue);
+            control.Add(vZerocoinChecks);
+            fValid = control.Wait();
+        } else {
+            for (CZerocoinSpendCheck& check : vZerocoinChecks) {
+                if (!check()) {
+                    fValid = false;
+                    break;
+                }
+            }
+        }
+        if (!fValid)
+            return state.DoS(100, error("CheckBlock() : zerocoin spend did not verify"),
+                REJECT_INVALID, "bad-zerocoinspend");
+    }
+
 
     unsigned int nSigOps = 0;
     BOOST_FOREACH (const CTransaction& tx, block.vtx) {
@@ -4808,7 +4881,7 @@ bool AcceptBlock(CBlock& block, CValidationState& state, CBlockIndex** ppindex,
 
                     //Check that the coinspend is valid
                     bool isInInvalidRange = isBlockBetweenFakeSerialAttackRange(pindex->nHeight);
-                    if(!spend.Verify(accumulator, !isInInvalidRange))
+                    if(!VerifyZerocoinSpendCached(spend, accumulator, !isInInvalidRange))
                         return state.DoS(100, error("%s: zerocoin spend did not verify", __func__));
 
                 }
@@ -5140,8 +5213,23 @@ CBlockIndex* InsertBlockIndex(uint256 hash)
 
 bool static LoadBlockIndexDB(string& strError)
 {
-    if (!pblocktree->LoadBlockIndexGuts())
+    // Up to the last checkpoint the stored hashes are trusted, ThreadVerifyBlockIndexHashes() checks them later
+    int nTrustedHeight = -1;
+    if (GetBoolArg("-trustblockindex", DEFAULT_TRUST_BLOCK_INDEX) && Checkpoints::fEnabled)
+        nTrustedHeight = Checkpoints::GetTotalBlocksEstimate();
+    int64_t nStart = GetTimeMillis();
+    if (!pblocktree->LoadBlockIndexGuts(nTrustedHeight))
+        return false;
+    LogPrintf("%s: loaded %u block index entries in %dms, trusting the stored hashes up to height %d\n", __func__,
+        mapBlockIndex.size(), GetTimeMillis() - nStart, nTrustedHeight);
+
+    // The checkpoint the trust rests on is checked right away
+    CBlockIndex* pcheckpoint = Checkpoints::GetLastCheckpoint();
+    if (nTrustedHeight >= 0 && pcheckpoint && pcheckpoint->GetBlockHeader().GetHash() != pcheckpoint->GetBlockHash()) {
+        strError = _("The last checkpoint in the block index does not match its header");
         return false;
+    }
+    ResetBlockIndexVerifyStatus(nTrustedHeight);
 
     boost::this_thread::interruption_point();
 
@@ -5331,12 +5419,73 @@ bool CVerifyDB::VerifyDB(CCoinsView* coinsview, int nCheckLevel, int nCheckDepth
     return true;
 }
 
+void ResetBlockIndexVerifyStatus(int nTrustedHeight)
+{
+    LOCK(cs_blockIndexVerify);
+    blockIndexVerifyStatus = CBlockIndexVerifyStatus();
+    blockIndexVerifyStatus.nTrustedHeight = nTrustedHeight;
+}
+
+CBlockIndexVerifyStatus GetBlockIndexVerifyStatus()
+{
+    LOCK(cs_blockIndexVerify);
+    return blockIndexVerifyStatus;
+}
+
+void ThreadVerifyBlockIndexHashes()
+{
+    std::vector<const CBlockIndex*> vIndex;
+    {
+        LOCK2(cs_main, cs_blockIndexVerify);
+        for (const std::pair<const uint256, CBlockIndex*>& item : mapBlockIndex) {
+            if (item.second->nHeight <= blockIndexVerifyStatus.nTrustedHeight)
+                vIndex.emplace_back(item.second);
+        }
+        blockIndexVerifyStatus.fRunning = true;
+        blockIndexVerifyStatus.nTotal = vIndex.size();
+    }
+    LogPrintf("%s: checking the hashes of %u block index entries\n", __func__, vIndex.size());
+
+    // The header fields and hashes of loaded entries do not change, they are read without cs_main
+    int64_t nStart = GetTimeMillis();
+    std::vector<CBlockHeader> vHeaders;
+    std::vector<uint256> vHashes;
+    for (size_t nBegin = 0; nBegin < vIndex.size(); nBegin += BLOCK_INDEX_LOAD_BATCH_SIZE) {
+        boost::this_thread::interruption_point();
+        size_t nEnd = std::min(nBegin + BLOCK_INDEX_LOAD_BATCH_SIZE, vIndex.size());
+        vHeaders.clear();
+        for (size_t i = nBegin; i < nEnd; i++)
+            vHeaders.emplace_back(vIndex[i]->GetBlockHeader());
+        HashQuarkN(vHeaders, vHashes);
+
+        LOCK(cs_blockIndexVerify);
+        for (size_t i = nBegin; i < nEnd; i++) {
+            if (vHashes[i - nBegin] == vIndex[i]->GetBlockHash())
+                continue;
+            LogPrintf("ERROR: %s: block index entry %s at height %d does not match its header hash %s\n", __func__,
+                vIndex[i]->GetBlockHash().ToString(), vIndex[i]->nHeight, vHashes[i - nBegin].ToString());
+            if (blockIndexVerifyStatus.nMismatches++ == 0)
+                blockIndexVerifyStatus.hashFirstMismatch = vIndex[i]->GetBlockHash();
+        }
+        blockIndexVerifyStatus.nChecked = nEnd;
+    }
+
+    LOCK(cs_blockIndexVerify);
+    blockIndexVerifyStatus.fRunning = false;
+    blockIndexVerifyStatus.fComplete = true;
+    LogPrintf("%s: checked %u block index entries in %dms, %u mismatches\n", __func__,
+        blockIndexVerifyStatus.nChecked, GetTimeMillis() - nStart, blockIndexVerifyStatus.nMismatches);
+    if (blockIndexVerifyStatus.nMismatches > 0)
+        strMiscWarning = _("Warning: The block index on disk is corrupted, restart with -reindex.");
+}
+
 void UnloadBlockIndex()
 {
     mapBlockIndex.clear();
     setBlockIndexCandidates.clear();
     chainActive.SetTip(NULL);
     pindexBestInvalid = NULL;
+    ResetMintMaturityCache();
 }
 
 bool LoadBlockIndex(string& strError)
@@ -6555,6 +6704,10 @@ bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv,
             ReadCompactSize(vRecv); // ignore tx count; assume it is 0.
         }
 
+        // Hash the whole message at once, before taking cs_main
+        std::vector<uint256> vHashes;
+        HashQuarkN(headers, vHashes);
+
         LOCK(cs_main);
 
         if (nCount == 0) {
@@ -6562,13 +6715,21 @@ bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv,
             return true;
         }
         CBlockIndex* pindexLast = NULL;
-        BOOST_FOREACH (const CBlockHeader& header, headers) {
+        for (unsigned int n = 0; n < nCount; n++) {
+            const CBlockHeader& header = headers[n];
             CValidationState state;
-            if (pindexLast != NULL && header.hashPrevBlock != pindexLast->GetBlockHash()) {
+            if (n > 0 && header.hashPrevBlock != vHashes[n - 1]) {
                 Misbehaving(pfrom->GetId(), 20);
                 return error("non-continuous headers sequence");
             }
 
+            // Known headers need no further checks, unless they were found invalid
+            BlockMap::iterator mi = mapBlockIndex.find(vHashes[n]);
+            if (mi != mapBlockIndex.end() && !(mi->second->nStatus & BLOCK_FAILED_MASK)) {
+                pindexLast = mi->second;
+                continue;
+            }
+
             /*TODO: this has a CBlock cast on it so that it will compile. There should be a solution for this
              * before headers are reimplemented on mainnet
              */
@@ -6577,7 +6738,7 @@ bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv,
                 if (state.IsInvalid(nDoS)) {
                     if (nDoS > 0)
                         Misbehaving(pfrom->GetId(), nDoS);
-                    std::string strError = "invalid header received " + header.GetHash().ToString();
+                    std::string strError = "invalid header received " + vHashes[n].ToString();
                     return error(strError.c_str());
                 }
             }
@@ -34,6 +34,7 @@
 #include <algorithm>
 #include <exception>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdint.h>
 #include <string>
@@ -52,6 +53,7 @@ class CSporkDB;
 class CBloomFilter;
 class CInv;
 class CScriptCheck;
+class CZerocoinSpendCheck;
 class CValidationInterface;
 class CValidationState;
 
@@ -91,6 +93,14 @@ static const int COINBASE_MATURITY = 100;
 static const int MAX_SCRIPTCHECK_THREADS = 16;
 /** -par default (number of script-checking threads, 0 = auto) */
 static const int DEFAULT_SCRIPTCHECK_THREADS = 0;
+/** Maximum number of zerocoin serial number proof checking threads allowed */
+static const int MAX_ZKPCHECK_THREADS = 16;
+/** -parzkp default (number of zerocoin serial number proof checking threads, 0 = auto) */
+static const int DEFAULT_ZKPCHECK_THREADS = 0;
+/** Maximum number of zerocoin spend checking threads allowed */
+static const int MAX_ZEROCOINCHECK_THREADS = 16;
+/** -parzerocoin default (number of zerocoin spend checking threads, 0 = auto) */
+static const int DEFAULT_ZEROCOINCHECK_THREADS = 0;
 /** Number of blocks that can be requested at any given time from a single peer. */
 static const int MAX_BLOCKS_IN_TRANSIT_PER_PEER = 16;
 /** Timeout in seconds during which a peer must stall block download progress before being disconnected. */
@@ -120,6 +130,9 @@ static const unsigned int DEFAULT_BLOCK_SPAM_FILTER_MAX_SIZE = COINBASE_MATURITY
 /** Default for -blockspamfiltermaxavg, maximum average size of an index occurrence in the block spam filter */
 static const unsigned int DEFAULT_BLOCK_SPAM_FILTER_MAX_AVG = 10;
 
+/** Default for -trustblockindex, load the block index with the stored hashes up to the last checkpoint */
+static const bool DEFAULT_TRUST_BLOCK_INDEX = true;
+
 /** "reject" message codes */
 static const unsigned char REJECT_MALFORMED = 0x01;
 static const unsigned char REJECT_INVALID = 0x10;
@@ -154,6 +167,7 @@ extern CConditionVariable cvBlockChange;
 extern bool fImporting;
 extern bool fReindex;
 extern int nScriptCheckThreads;
+extern int nZerocoinSpendCheckThreads;
 extern bool fTxIndex;
 extern bool fIsBareMultisigStd;
 extern bool fCheckBlockIndex;
@@ -219,6 +233,24 @@ bool InitBlockIndex();
 bool LoadBlockIndex(std::string& strError);
 /** Unload database information */
 void UnloadBlockIndex();
+
+/** Progress of the background check of the block index hashes trusted at startup */
+struct CBlockIndexVerifyStatus {
+    int nTrustedHeight; //! -1 when every entry was hashed at startup
+    bool fRunning;
+    bool fComplete;
+    size_t nChecked;
+    size_t nTotal;
+    size_t nMismatches;
+    uint256 hashFirstMismatch;
+
+    CBlockIndexVerifyStatus() : nTrustedHeight(-1), fRunning(false), fComplete(false), nChecked(0), nTotal(0), nMismatches(0) {}
+};
+CBlockIndexVerifyStatus GetBlockIndexVerifyStatus();
+/** Start over the progress for a block index loaded with the stored hashes up to nTrustedHeight */
+void ResetBlockIndexVerifyStatus(int nTrustedHeight);
+/** Re-hash the headers of the block index entries loaded with their stored hash */
+void ThreadVerifyBlockIndexHashes();
 /** See whether the protocol update is enforced for connected nodes */
 int ActiveProtocol();
 /** Process protocol messages received from a given node */
@@ -232,6 +264,8 @@ bool ProcessMessages(CNode* pfrom);
 bool SendMessages(CNode* pto, bool fSendTrickle);
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the zerocoin spend checking thread */
+void ThreadZerocoinSpendCheck();
 
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
@@ -359,9 +393,9 @@ bool CheckInputs(const CTransaction& tx, CValidationState& state, const CCoinsVi
 void UpdateCoins(const CTransaction& tx, CValidationState& state, CCoinsViewCache& inputs, CTxUndo& txundo, int nHeight);
 
 /** Context-independent validity checks */
-bool CheckTransaction(const CTransaction& tx, bool fZerocoinActive, bool fRejectBadUTXO, CValidationState& state, bool fFakeSerialAttack = false);
+bool CheckTransaction(const CTransaction& tx, bool fZerocoinActive, bool fRejectBadUTXO, CValidationState& state, bool fFakeSerialAttack = false, std::vector<CZerocoinSpendCheck>* pvZerocoinChecks = NULL);
 bool CheckZerocoinMint(const uint256& txHash, const CTxOut& txout, CValidationState& state, bool fCheckOnly = false);
-bool CheckZerocoinSpend(const CTransaction& tx, bool fVerifySignature, CValidationState& state, bool fFakeSerialAttack = false);
+bool CheckZerocoinSpend(const CTransaction& tx, bool fVerifySignature, CValidationState& state, bool fFakeSerialAttack = false, std::vector<CZerocoinSpendCheck>* pvChecks = NULL);
 bool ContextualCheckZerocoinSpend(const CTransaction& tx, const libzerocoin::CoinSpend& spend, CBlockIndex* pindex, const uint256& hashBlock);
 bool ContextualCheckZerocoinSpendNoSerialCheck(const CTransaction& tx, const libzerocoin::CoinSpend& spend, CBlockIndex* pindex, const uint256& hashBlock);
 bool IsTransactionInChain(const uint256& txId, int& nHeightTx, CTransaction& tx);
@@ -445,6 +479,33 @@ public:
     ScriptError GetScriptError() const { return error; }
 };
 
+/**
+ * Closure representing the proof verification of one zerocoin spend
+ * against the accumulator value it claims to have been accumulated in
+ */
+class CZerocoinSpendCheck
+{
+private:
+    std::shared_ptr<const libzerocoin::CoinSpend> pspend;
+    libzerocoin::ZerocoinParams* params;
+    CBigNum bnAccumulatorValue;
+    bool fVerifyParams;
+
+public:
+    CZerocoinSpendCheck() : params(NULL), fVerifyParams(true) {}
+    CZerocoinSpendCheck(const libzerocoin::CoinSpend& spendIn, libzerocoin::ZerocoinParams* paramsIn, const CBigNum& bnAccumulatorValueIn, bool fVerifyParamsIn) : pspend(std::make_shared<const libzerocoin::CoinSpend>(spendIn)), params(paramsIn), bnAccumulatorValue(bnAccumulatorValueIn), fVerifyParams(fVerifyParamsIn) {}
+
+    bool operator()();
+
+    void swap(CZerocoinSpendCheck& check)
+    {
+        pspend.swap(check.pspend);
+        std::swap(params, check.params);
+        std::swap(bnAccumulatorValue, check.bnAccumulatorValue);
+        std::swap(fVerifyParams, check.fVerifyParams);
+    }
+};
+
 
 /** Functions for disk access for blocks */
 bool WriteBlockToDisk(CBlock& block, CDiskBlockPos& pos);
@@ -7,12 +7,17 @@
 #include "primitives/block.h"
 
 #include "hash.h"
+#include "crypto/sha256.h"
 #include "script/standard.h"
 #include "script/sign.h"
 #include "tinyformat.h"
 #include "utilstrencodings.h"
 #include "util.h"
 
+#include <atomic>
+
+#include <boost/thread.hpp>
+
 uint256 CBlockHeader::GetHash() const
 {
     if(nVersion < 4)
@@ -21,6 +26,35 @@ uint256 CBlockHeader::GetHash() const
     return Hash(BEGIN(nVersion), END(nAccumulatorCheckpoint));
 }
 
+void HashQuarkN(const std::vector<CBlockHeader>& vHeaders, std::vector<uint256>& vHashes)
+{
+    vHashes.resize(vHeaders.size());
+
+    // A thread is only worth starting for a few headers, the hashes are handed out in chunks of that size
+    static const size_t nChunk = 16;
+    size_t nThreads = std::min<size_t>(std::max(boost::thread::hardware_concurrency(), 1u), vHeaders.size() / nChunk);
+    if (nThreads <= 1) {
+        for (size_t i = 0; i < vHeaders.size(); i++)
+            vHashes[i] = vHeaders[i].GetHash();
+        return;
+    }
+
+    std::atomic<size_t> nNext(0);
+    auto hash = [&]() {
+        size_t nBegin;
+        while ((nBegin = nNext.fetch_add(nChunk)) < vHeaders.size()) {
+            size_t nEnd = std::min(nBegin + nChunk, vHeaders.size());
+            for (size_t i = nBegin; i < nEnd; i++)
+                vHashes[i] = vHeaders[i].GetHash();
+        }
+    };
+
+    boost::thread_group threadGroup;
+    for (size_t t = 0; t < nThreads; t++)
+        threadGroup.create_thread(hash);
+    threadGroup.join_all();
+}
+
 uint256 CBlock::BuildMerkleTree(bool* fMutated) const
 {
     /* WARNING! If you're reading this because you're learning about crypto
@@ -66,15 +100,17 @@ uint256 CBlock::BuildMerkleTree(bool* fMutated) const
     bool mutated = false;
     for (int nSize = vtx.size(); nSize > 1; nSize = (nSize + 1) / 2)
     {
-        for (int i = 0; i < nSize; i += 2)
-        {
-            int i2 = std::min(i+1, nSize-1);
-            if (i2 == i + 1 && i2 + 1 == nSize && vMerkleTree[j+i] == vMerkleTree[j+i2]) {
-                // Two identical hashes at the end of the list at a particular level.
-                mutated = true;
-            }
-            vMerkleTree.push_back(Hash(BEGIN(vMerkleTree[j+i]),  END(vMerkleTree[j+i]),
-                                       BEGIN(vMerkleTree[j+i2]), END(vMerkleTree[j+i2])));
+        if (nSize % 2 == 0 && vMerkleTree[j+nSize-2] == vMerkleTree[j+nSize-1]) {
+            // Two identical hashes at the end of the list at a particular level.
+            mutated = true;
+        }
+        // The pairs of the level are contiguous 64-byte inputs, hash them all at once
+        vMerkleTree.resize(j + nSize + (nSize + 1) / 2);
+        SHA256D64(vMerkleTree[j+nSize].begin(), vMerkleTree[j].begin(), nSize / 2);
+        if (nSize % 2 == 1) {
+            // The last hash of an odd level is paired with itself
+            const uint256& hashLast = vMerkleTree[j+nSize-1];
+            vMerkleTree.back() = Hash(BEGIN(hashLast), END(hashLast), BEGIN(hashLast), END(hashLast));
         }
         j += nSize;
     }
@@ -84,6 +120,37 @@ uint256 CBlock::BuildMerkleTree(bool* fMutated) const
     return (vMerkleTree.empty() ? uint256() : vMerkleTree.back());
 }
 
+uint256 CBlock::GetMerkleRoot(bool* fMutated) const
+{
+    std::vector<uint256> vHashes;
+    vHashes.reserve(vtx.size());
+    for (const CTransaction& tx : vtx)
+        vHashes.push_back(tx.GetHash());
+    return ComputeMerkleRoot(vHashes, fMutated);
+}
+
+uint256 CBlock::ComputeMerkleRoot(std::vector<uint256> vHashes, bool* fMutated)
+{
+    static_assert(sizeof(uint256) == 32, "the hashes of a level are hashed as contiguous 64-byte pairs");
+
+    // Each level overwrites the front of the one below it
+    bool mutated = false;
+    while (vHashes.size() > 1) {
+        if (vHashes.size() % 2 == 1) {
+            vHashes.push_back(vHashes.back());
+        } else if (vHashes[vHashes.size() - 2] == vHashes.back()) {
+            // Two identical hashes at the end of the list at a particular level.
+            mutated = true;
+        }
+        SHA256D64(vHashes[0].begin(), vHashes[0].begin(), vHashes.size() / 2);
+        vHashes.resize(vHashes.size() / 2);
+    }
+    if (fMutated) {
+        *fMutated = mutated;
+    }
+    return (vHashes.empty() ? uint256() : vHashes[0]);
+}
+
 std::vector<uint256> CBlock::GetMerkleBranch(int nIndex) const
 {
     if (vMerkleTree.empty())
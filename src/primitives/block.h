@@ -165,6 +165,11 @@ public:
     // merkle root).
     uint256 BuildMerkleTree(bool* mutated = NULL) const;
 
+    // The merkle root of BuildMerkleTree(), without keeping the tree.
+    uint256 GetMerkleRoot(bool* mutated = NULL) const;
+    // The merkle root of a list of leaves, computed in place one level at a time.
+    static uint256 ComputeMerkleRoot(std::vector<uint256> vHashes, bool* mutated = NULL);
+
     std::vector<uint256> GetMerkleBranch(int nIndex) const;
     static uint256 CheckMerkleBranch(uint256 hash, const std::vector<uint256>& vMerkleBranch, int nIndex);
     std::string ToString() const;
@@ -172,6 +177,11 @@ public:
 };
 
 
+/** The hashes of a batch of headers, GetHash() of each one. The legacy headers use the slow
+ *  Quark hash, a large batch is spread over a thread per core.
+ */
+void HashQuarkN(const std::vector<CBlockHeader>& vHeaders, std::vector<uint256>& vHashes);
+
 /** Describes a place in the block chain to another node such that if the
  * other node doesn't have the same branch, it can find a recent common trunk.
  * The further back it is, the further before the fork it may be.
@@ -10,6 +10,7 @@
 #include "clientversion.h"
 #include "main.h"
 #include "rpc/server.h"
+#include "script/sigcache.h"
 #include "sync.h"
 #include "txdb.h"
 #include "util.h"
@@ -991,6 +992,41 @@ UniValue getchaintips(const UniValue& params, bool fHelp)
     return res;
 }
 
+UniValue getblockindexverification(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() != 0)
+        throw runtime_error(
+            "getblockindexverification\n"
+            "\nReturns the progress of the background check of the block index hashes trusted at startup (see -trustblockindex).\n"
+
+            "\nResult:\n"
+            "{\n"
+            "  \"trustedheight\": n,      (numeric) height up to which the stored hashes were trusted, -1 if none were\n"
+            "  \"running\": true|false,   (boolean) whether the check is in progress\n"
+            "  \"complete\": true|false,  (boolean) whether the check has finished\n"
+            "  \"checked\": n,            (numeric) number of entries checked so far\n"
+            "  \"total\": n,              (numeric) number of entries to check\n"
+            "  \"mismatches\": n,         (numeric) number of entries that do not match their header hash\n"
+            "  \"firstmismatch\": \"hash\" (string, optional) the first entry that did not match\n"
+            "}\n"
+
+            "\nExamples:\n" +
+            HelpExampleCli("getblockindexverification", "") + HelpExampleRpc("getblockindexverification", ""));
+
+    CBlockIndexVerifyStatus status = GetBlockIndexVerifyStatus();
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("trustedheight", status.nTrustedHeight));
+    ret.push_back(Pair("running", status.fRunning));
+    ret.push_back(Pair("complete", status.fComplete));
+    ret.push_back(Pair("checked", (uint64_t)status.nChecked));
+    ret.push_back(Pair("total", (uint64_t)status.nTotal));
+    ret.push_back(Pair("mismatches", (uint64_t)status.nMismatches));
+    if (status.nMismatches > 0)
+        ret.push_back(Pair("firstmismatch", status.hashFirstMismatch.GetHex()));
+
+    return ret;
+}
+
 UniValue getfeeinfo(const UniValue& params, bool fHelp)
 {
     if (fHelp || params.size() != 1)
@@ -1082,6 +1118,14 @@ UniValue mempoolInfoToJSON()
     ret.push_back(Pair("bytes", (int64_t) mempool.GetTotalTxSize()));
     //ret.push_back(Pair("usage", (int64_t) mempool.DynamicMemoryUsage()));
 
+    const CSignatureCache& sigcache = GetSignatureCache();
+    UniValue sigcacheObj(UniValue::VOBJ);
+    sigcacheObj.push_back(Pair("size", (uint64_t) sigcache.GetCapacity()));
+    sigcacheObj.push_back(Pair("entries", (uint64_t) sigcache.GetEntries()));
+    sigcacheObj.push_back(Pair("hits", sigcache.GetHits()));
+    sigcacheObj.push_back(Pair("misses", sigcache.GetMisses()));
+    ret.push_back(Pair("sigcache", sigcacheObj));
+
     return ret;
 }
 
@@ -1096,6 +1140,12 @@ UniValue getmempoolinfo(const UniValue& params, bool fHelp)
             "{\n"
             "  \"size\": xxxxx                (numeric) Current tx count\n"
             "  \"bytes\": xxxxx               (numeric) Sum of all tx sizes\n"
+            "  \"sigcache\": {                (json object) The signature cache\n"
+            "    \"size\": xxxxx              (numeric) Number of entries it has room for\n"
+            "    \"entries\": xxxxx           (numeric) Number of valid signatures it holds\n"
+            "    \"hits\": xxxxx              (numeric) Lookups that found the signature since startup\n"
+            "    \"misses\": xxxxx            (numeric) Lookups that did not\n"
+            "  }\n"
             "}\n"
 
             "\nExamples:\n" +
@@ -1324,8 +1374,6 @@ UniValue getmintsinblocks(const UniValue& params, bool fHelp) {
                 HelpExampleCli("getmintsinblocks", "1200000 1000 5") +
                 HelpExampleRpc("getmintsinblocks", "1200000, 1000, 5"));
 
-    int nBestHeight = chainActive.Height();
-
     int heightStart = params[0].get_int();
     if (heightStart < Params().Zerocoin_StartHeight())
         heightStart = Params().Zerocoin_StartHeight();
@@ -1334,35 +1382,35 @@ UniValue getmintsinblocks(const UniValue& params, bool fHelp) {
     if (range < 1)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid block range. Must be strictly positive.");
 
-    int heightEnd = heightStart + range - 1;
-    if (heightEnd > nBestHeight)
-        heightEnd = nBestHeight;
-
     int d = params[2].get_int();
     libzerocoin::CoinDenomination denom = libzerocoin::IntToZerocoinDenomination(d);
     if (denom == libzerocoin::CoinDenomination::ZQ_ERROR)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid denomination. Must be in {1, 5, 10, 50, 100, 500, 1000, 5000}");
 
+    // The mint denominations are kept in the block index, counting them never reads a block
     int num_of_mints = 0;
-    CBlockIndex* pindex = chainActive[heightStart];
-
-    while (true) {
-        num_of_mints += count(pindex->vMintDenominationsInBlock.begin(), pindex->vMintDenominationsInBlock.end(), denom);
-        if (pindex->nHeight < heightEnd)
-            pindex = chainActive.Next(pindex);
-        else
-            break;
+    int heightEnd;
+    {
+        LOCK(cs_main);
+        heightEnd = std::min(heightStart + range - 1, chainActive.Height());
+        for (int nHeight = heightStart; nHeight <= heightEnd; nHeight++) {
+            const CBlockIndex* pindex = chainActive[nHeight];
+            num_of_mints += count(pindex->vMintDenominationsInBlock.begin(), pindex->vMintDenominationsInBlock.end(), denom);
+        }
     }
 
     UniValue obj(UniValue::VOBJ);
     obj.push_back(Pair("Starting block", heightStart));
-    obj.push_back(Pair("Ending block", pindex->nHeight));
+    obj.push_back(Pair("Ending block", heightEnd));
     obj.push_back(Pair("Number of "+ std::to_string(d) +"-denom mints", num_of_mints));
 
     return obj;
 }
 
 
+/** Number of blocks getserials reads at once */
+static const size_t GETSERIALS_BATCH_SIZE = 1000;
+
 UniValue getserials(const UniValue& params, bool fHelp) {
     if (fHelp || params.size() < 2 || params.size() > 3)
         throw runtime_error(
@@ -1378,10 +1426,6 @@ UniValue getserials(const UniValue& params, bool fHelp) {
             HelpExampleCli("getserials", "1254000 1000") +
             HelpExampleRpc("getserials", "1254000, 1000"));
 
-    LOCK(cs_main);
-
-    int nBestHeight = chainActive.Height();
-
     int heightStart = params[0].get_int();
     if (heightStart < Params().Zerocoin_StartHeight())
         heightStart = Params().Zerocoin_StartHeight();
@@ -1390,75 +1434,68 @@ UniValue getserials(const UniValue& params, bool fHelp) {
     if (range < 1)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid block range. Must be strictly positive.");
 
-    int heightEnd = heightStart + range - 1;
-    if (heightEnd > nBestHeight)
-        heightEnd = nBestHeight;
-
     bool fVerbose = false;
     if (params.size() > 2) {
         fVerbose = params[2].get_bool();
     }
 
-    CBlockIndex* pblockindex = chainActive[heightStart];
+    // Only hold cs_main to look the blocks up, the serials come from the zerocoinDB index
+    std::vector<const CBlockIndex*> vBlocks;
+    {
+        LOCK(cs_main);
+        int heightEnd = std::min(heightStart + range - 1, chainActive.Height());
+        for (int nHeight = heightStart; nHeight <= heightEnd; nHeight++)
+            vBlocks.emplace_back(chainActive[nHeight]);
+    }
 
-    UniValue serialsObj(UniValue::VOBJ);    // for fVerbose
     UniValue serialsArr(UniValue::VARR);
 
-    while (true) {
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pblockindex))
-                throw JSONRPCError(RPC_INTERNAL_ERROR, "Can't read block from disk");
+    // Read the blocks in batches, so a wide range does not keep the serials of all the blocks in memory
+    for (size_t nBatchStart = 0; nBatchStart < vBlocks.size(); nBatchStart += GETSERIALS_BATCH_SIZE) {
+        std::vector<const CBlockIndex*> vBatch(vBlocks.begin() + nBatchStart,
+                vBlocks.begin() + std::min(nBatchStart + GETSERIALS_BATCH_SIZE, vBlocks.size()));
+        std::vector<std::vector<CBlockSerial> > vBlockSerials;
+        if (!GetBlockSerialLists(vBatch, vBlockSerials))
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "Can't read block from disk");
+
+        for (size_t i = 0; i < vBatch.size(); i++) {
+            for (const CBlockSerial& spend : vBlockSerials[i]) {
+                std::string serial_str = spend.bnSerial.ToString(16);
+                if (!fVerbose) {
+                    serialsArr.push_back(serial_str);
+                    continue;
+                }
 
-        // loop through each tx in the block
-        for (const CTransaction& tx : block.vtx) {
-            std::string txid = tx.GetHash().GetHex();
-            // collect the destination (first output) if fVerbose
-            std::string spentTo = "";
-            if (fVerbose) {
-                if (tx.vout[0].IsZerocoinMint()) {
+                // the destination (first output) of the spending tx
+                std::string spentTo = "";
+                const CTxOut& txout = spend.txoutSpentTo;
+                if (txout.IsZerocoinMint()) {
                     spentTo = "Zerocoin Mint";
-                } else if (tx.vout[0].IsEmpty()) {
+                } else if (txout.IsEmpty()) {
                     spentTo = "Zerocoin Stake";
                 } else {
                     txnouttype type;
                     vector<CTxDestination> addresses;
                     int nRequired;
-                    if (!ExtractDestinations(tx.vout[0].scriptPubKey, type, addresses, nRequired)) {
+                    if (!ExtractDestinations(txout.scriptPubKey, type, addresses, nRequired)) {
                         spentTo = strprintf("type: %d", GetTxnOutputType(type));
                     } else {
                         spentTo = CBitcoinAddress(addresses[0]).ToString();
                     }
                 }
-            }
-            // loop through each input
-            for (const CTxIn& txin : tx.vin) {
-                if (txin.scriptSig.IsZerocoinSpend()) {
-                    libzerocoin::CoinSpend spend = TxInToZerocoinSpend(txin);
-                    std::string serial_str = spend.getCoinSerialNumber().ToString(16);
-                    if (!fVerbose) {
-                        serialsArr.push_back(serial_str);
-                    } else {
-                        int denom = libzerocoin::ZerocoinDenominationToInt(spend.getDenomination());
-                        UniValue s(UniValue::VOBJ);
-                        s.push_back(Pair("serial", serial_str));
-                        s.push_back(Pair("denom", denom));
-                        s.push_back(Pair("bitsize", (int)serial_str.size()*4));
-                        s.push_back(Pair("spentTo", spentTo));
-                        s.push_back(Pair("txid", txid));
-                        s.push_back(Pair("blocknum", pblockindex->nHeight));
-                        s.push_back(Pair("blocktime", block.GetBlockTime()));
-                        serialsArr.push_back(s);
-                    }
-
-                }
-
-            } // end for vin in tx
-        } // end for tx in block
-
-        if (pblockindex->nHeight < heightEnd) pblockindex = chainActive.Next(pblockindex);
-        else break;
 
-    } // end for blocks
+                UniValue s(UniValue::VOBJ);
+                s.push_back(Pair("serial", serial_str));
+                s.push_back(Pair("denom", libzerocoin::ZerocoinDenominationToInt(spend.denom)));
+                s.push_back(Pair("bitsize", (int)serial_str.size()*4));
+                s.push_back(Pair("spentTo", spentTo));
+                s.push_back(Pair("txid", spend.txid.GetHex()));
+                s.push_back(Pair("blocknum", vBatch[i]->nHeight));
+                s.push_back(Pair("blocktime", vBatch[i]->GetBlockTime()));
+                serialsArr.push_back(s);
+            }
+        }
+    }
 
     return serialsArr;
 
@@ -367,6 +367,44 @@ UniValue getnettotals(const UniValue& params, bool fHelp)
     return obj;
 }
 
+UniValue getlightworkerinfo(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() > 0)
+        throw runtime_error(
+            "getlightworkerinfo\n"
+            "\nReturns the state of the queue of zerocoin light node witness requests.\n"
+
+            "\nResult:\n"
+            "{\n"
+            "  \"running\": true|false,   (boolean) Whether the witness workers are running\n"
+            "  \"depth\": n,              (numeric) Requests waiting for a worker\n"
+            "  \"maxdepth\": n,           (numeric) Highest number of requests that were waiting at once\n"
+            "  \"capacity\": n,           (numeric) Max number of waiting requests\n"
+            "  \"pushed\": n,             (numeric) Requests queued since startup\n"
+            "  \"popped\": n,             (numeric) Requests taken by a worker since startup\n"
+            "  \"rejected\": n,           (numeric) Requests rejected because the queue was full\n"
+            "  \"avgwaitmillis\": n,      (numeric) Average time a request waited for a worker\n"
+            "  \"maxwaitmillis\": n       (numeric) Longest time a request waited for a worker\n"
+            "}\n"
+
+            "\nExamples:\n" +
+            HelpExampleCli("getlightworkerinfo", "") + HelpExampleRpc("getlightworkerinfo", ""));
+
+    CBoundedQueue<CGenWit>::Stats stats = lightWorker.GetQueueStats();
+
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("running", lightWorker.IsRunning()));
+    obj.push_back(Pair("depth", (uint64_t)stats.nDepth));
+    obj.push_back(Pair("maxdepth", (uint64_t)stats.nMaxDepth));
+    obj.push_back(Pair("capacity", (uint64_t)stats.nCapacity));
+    obj.push_back(Pair("pushed", stats.nPushed));
+    obj.push_back(Pair("popped", stats.nPopped));
+    obj.push_back(Pair("rejected", stats.nRejected));
+    obj.push_back(Pair("avgwaitmillis", stats.nPopped ? 0.001 * stats.nTotalWaitMicros / stats.nPopped : 0.0));
+    obj.push_back(Pair("maxwaitmillis", 0.001 * stats.nMaxWaitMicros));
+    return obj;
+}
+
 static UniValue GetNetworksInfo()
 {
     UniValue networks(UniValue::VARR);
@@ -5,84 +5,137 @@
 
 #include "sigcache.h"
 
+#include "crypto/common.h"
+#include "crypto/sha256.h"
 #include "pubkey.h"
 #include "random.h"
-#include "uint256.h"
 #include "util.h"
 
-#include <boost/thread.hpp>
-#include <boost/tuple/tuple_comparison.hpp>
+#include <boost/thread/locks.hpp>
 
-namespace {
+CSignatureCache::CSignatureCache() : nMaxDepth(0), nRound(0), nEntries(0), nHits(0), nMisses(0)
+{
+    GetRandBytes(nonce, sizeof(nonce));
+}
 
-/**
- * Valid signature cache, to avoid doing expensive ECDSA signature checking
- * twice for every transaction (once when accepted into memory pool, and
- * again when accepted into the block chain)
- */
-class CSignatureCache
+void CSignatureCache::Setup(size_t nBytes)
 {
-private:
-     //! sigdata_type is (signature hash, signature, public key):
-    typedef boost::tuple<uint256, std::vector<unsigned char>, CPubKey> sigdata_type;
-    std::set< sigdata_type> setValid;
-    boost::shared_mutex cs_sigcache;
-
-public:
-    bool
-    Get(const uint256 &hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubKey)
-    {
-        boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
-
-        sigdata_type k(hash, vchSig, pubKey);
-        std::set<sigdata_type>::iterator mi = setValid.find(k);
-        if (mi != setValid.end())
-            return true;
-        return false;
-    }
+    boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
+    vTable.assign(nBytes / sizeof(uint256), uint256());
+    nEntries = 0;
+
+    // Moves before an entry is dropped, about log2 of the table size
+    nMaxDepth = 1;
+    while (((size_t)1 << nMaxDepth) < vTable.size())
+        nMaxDepth++;
+}
+
+void CSignatureCache::ComputeEntry(uint256& entry, const uint256& hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubkey) const
+{
+    CSHA256().Write(nonce, sizeof(nonce)).Write(hash.begin(), 32).Write(pubkey.begin(), pubkey.size()).Write(vchSig.data(), vchSig.size()).Finalize(entry.begin());
+}
 
-    void Set(const uint256 &hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubKey)
-    {
-        // DoS prevention: limit cache size to less than 10MB
-        // (~200 bytes per cache entry times 50,000 entries)
-        // Since there are a maximum of 20,000 signature operations per block
-        // 50,000 is a reasonable default.
-        int64_t nMaxCacheSize = GetArg("-maxsigcachesize", 50000);
-        if (nMaxCacheSize <= 0) return;
-
-        boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
-
-        while (static_cast<int64_t>(setValid.size()) > nMaxCacheSize)
-        {
-            // Evict a random entry. Random because that helps
-            // foil would-be DoS attackers who might try to pre-generate
-            // and re-use a set of valid signatures just-slightly-greater
-            // than our cache size.
-            uint256 randomHash = GetRandHash();
-            std::set<sigdata_type>::iterator it = setValid.lower_bound(sigdata_type(randomHash));
-            if (it == setValid.end())
-                it = setValid.begin();
-            setValid.erase(*it);
+void CSignatureCache::GetSlots(const uint256& entry, uint32_t slots[SLOTS_PER_ENTRY]) const
+{
+    // The digest is uniformly random, each 32-bit word of it maps to a slot
+    for (int i = 0; i < SLOTS_PER_ENTRY; i++)
+        slots[i] = ((uint64_t)ReadLE32(entry.begin() + 4 * i) * vTable.size()) >> 32;
+}
+
+bool CSignatureCache::Get(const uint256& entry) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
+    if (!vTable.empty()) {
+        uint32_t slots[SLOTS_PER_ENTRY];
+        GetSlots(entry, slots);
+        for (int i = 0; i < SLOTS_PER_ENTRY; i++) {
+            if (vTable[slots[i]] == entry) {
+                nHits++;
+                return true;
+            }
         }
+    }
+    nMisses++;
+    return false;
+}
 
-        sigdata_type k(hash, vchSig, pubKey);
-        setValid.insert(k);
+void CSignatureCache::Set(const uint256& entry)
+{
+    boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
+    if (vTable.empty())
+        return;
+
+    uint32_t slots[SLOTS_PER_ENTRY];
+    GetSlots(entry, slots);
+    for (int i = 0; i < SLOTS_PER_ENTRY; i++) {
+        if (vTable[slots[i]] == entry)
+            return;
     }
-};
 
+    uint256 entryMoved = entry;
+    uint32_t nSlotFrom = vTable.size();
+    for (uint32_t nDepth = 0; nDepth <= nMaxDepth; nDepth++) {
+        for (int i = 0; i < SLOTS_PER_ENTRY; i++) {
+            if (vTable[slots[i]].IsNull()) {
+                vTable[slots[i]] = entryMoved;
+                nEntries++;
+                return;
+            }
+        }
+        if (nDepth == nMaxDepth)
+            break;
+
+        // All the slots are taken, take one over and move its entry on, not back to where this one came from
+        uint32_t nSlot = slots[nRound++ % SLOTS_PER_ENTRY];
+        if (nSlot == nSlotFrom)
+            nSlot = slots[nRound++ % SLOTS_PER_ENTRY];
+        std::swap(vTable[nSlot], entryMoved);
+        nSlotFrom = nSlot;
+        GetSlots(entryMoved, slots);
+    }
+    // entryMoved found no free slot and is dropped, the entry count is unchanged
+}
+
+size_t CSignatureCache::GetCapacity() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
+    return vTable.size();
+}
+
+size_t CSignatureCache::GetEntries() const
+{
+    boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
+    return nEntries;
+}
+
+namespace {
+CSignatureCache signatureCache;
+}
+
+void InitSignatureCache()
+{
+    int64_t nMaxCacheSize = std::min(std::max(GetArg("-maxsigcachesize", DEFAULT_MAX_SIG_CACHE_SIZE), (int64_t)0), MAX_MAX_SIG_CACHE_SIZE);
+    signatureCache.Setup(nMaxCacheSize << 20);
+    LogPrintf("Using %d MiB for the signature cache, %u entries\n", nMaxCacheSize, signatureCache.GetCapacity());
+}
+
+const CSignatureCache& GetSignatureCache()
+{
+    return signatureCache;
 }
 
 bool CachingTransactionSignatureChecker::VerifySignature(const std::vector<unsigned char>& vchSig, const CPubKey& pubkey, const uint256& sighash) const
 {
-    static CSignatureCache signatureCache;
+    uint256 entry;
+    signatureCache.ComputeEntry(entry, sighash, vchSig, pubkey);
 
-    if (signatureCache.Get(sighash, vchSig, pubkey))
+    if (signatureCache.Get(entry))
         return true;
 
     if (!TransactionSignatureChecker::VerifySignature(vchSig, pubkey, sighash))
         return false;
 
     if (store)
-        signatureCache.Set(sighash, vchSig, pubkey);
+        signatureCache.Set(entry);
     return true;
 }
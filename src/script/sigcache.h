@@ -7,11 +7,70 @@
 #define BITCOIN_SCRIPT_SIGCACHE_H
 
 #include "script/interpreter.h"
+#include "uint256.h"
 
+#include <atomic>
 #include <vector>
 
+#include <boost/thread/shared_mutex.hpp>
+
+//! Default for -maxsigcachesize, in MiB
+static const int64_t DEFAULT_MAX_SIG_CACHE_SIZE = 32;
+//! Largest -maxsigcachesize accepted, in MiB
+static const int64_t MAX_MAX_SIG_CACHE_SIZE = 1024;
+
 class CPubKey;
 
+/**
+ * Valid signature cache, to avoid doing expensive ECDSA signature checking
+ * twice for every transaction (once when accepted into memory pool, and
+ * again when accepted into the block chain).
+ *
+ * Entries are 32-byte salted digests of (signature hash, public key, signature),
+ * kept in a fixed table with 8 possible slots per entry, picked from the digest.
+ * A full slot set makes room cuckoo style: an entry is moved to another of its slots,
+ * and the one left without a slot after a few moves is dropped. The salt keeps
+ * attackers from choosing which entries collide or get evicted.
+ * Lookups only take the lock shared.
+ */
+class CSignatureCache
+{
+private:
+    static const int SLOTS_PER_ENTRY = 8;
+
+    std::vector<uint256> vTable;
+    unsigned char nonce[32];
+    uint32_t nMaxDepth;
+    uint32_t nRound;
+    size_t nEntries;
+    mutable boost::shared_mutex cs_sigcache;
+
+    mutable std::atomic<uint64_t> nHits;
+    mutable std::atomic<uint64_t> nMisses;
+
+    void GetSlots(const uint256& entry, uint32_t slots[SLOTS_PER_ENTRY]) const;
+
+public:
+    CSignatureCache();
+
+    /** Drop all the entries and size the table to nBytes, 0 disables the cache */
+    void Setup(size_t nBytes);
+
+    void ComputeEntry(uint256& entry, const uint256& hash, const std::vector<unsigned char>& vchSig, const CPubKey& pubkey) const;
+    bool Get(const uint256& entry) const;
+    void Set(const uint256& entry);
+
+    size_t GetCapacity() const;
+    size_t GetEntries() const;
+    uint64_t GetHits() const { return nHits; }
+    uint64_t GetMisses() const { return nMisses; }
+};
+
+/** Size the cache used by CachingTransactionSignatureChecker from -maxsigcachesize */
+void InitSignatureCache();
+/** The cache used by CachingTransactionSignatureChecker */
+const CSignatureCache& GetSignatureCache();
+
 class CachingTransactionSignatureChecker : public TransactionSignatureChecker
 {
 private:
@@ -0,0 +1,139 @@
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "main.h"
+#include "rpc/server.h"
+#include "txdb.h"
+#include "util.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <univalue.h>
+
+extern UniValue CallRPC(std::string args);
+
+static CBlockHeader MakeHeader(uint32_t nNonce)
+{
+    CBlockHeader header;
+    header.nVersion = 3;
+    header.nTime = 1500000000;
+    header.nBits = 0x1e0ffff0;
+    header.nNonce = nNonce;
+    return header;
+}
+
+// An entry stored under hashStored, a hash other than the header's stands for a tampered entry
+static void WriteEntry(CBlockTreeDB& blocktree, const CBlockHeader& header, int nHeight, const uint256& hashStored)
+{
+    CBlockIndex index{CBlock(header)};
+    index.nHeight = nHeight;
+    index.phashBlock = &hashStored;
+    // Written like WriteBlockIndex(), which would key it by the header hash
+    BOOST_CHECK(blocktree.Write(std::make_pair('b', hashStored), CDiskBlockIndex(&index)));
+}
+
+static void InsertEntry(const CBlockHeader& header, int nHeight, const uint256& hashStored)
+{
+    CBlockIndex* pindex = new CBlockIndex(CBlock(header));
+    pindex->nHeight = nHeight;
+    pindex->phashBlock = &mapBlockIndex.insert(std::make_pair(hashStored, pindex)).first->first;
+}
+
+static void ClearEntries()
+{
+    for (const std::pair<const uint256, CBlockIndex*>& item : mapBlockIndex)
+        delete item.second;
+    mapBlockIndex.clear();
+}
+
+BOOST_AUTO_TEST_SUITE(blockindex_tests)
+
+BOOST_AUTO_TEST_CASE(blockindex_trusted_load)
+{
+    // Far enough above the proof of work blocks that the test headers need no valid proof
+    const int nTrustedHeight = Params().LAST_POW_BLOCK() + 100;
+    LOCK(cs_main);
+    BlockMap mapBlockIndexOld;
+    mapBlockIndexOld.swap(mapBlockIndex);
+
+    CBlockTreeDB blocktree(1 << 20, true);
+    uint256 hashBelow = MakeHeader(1).GetHash();
+    uint256 hashGood = MakeHeader(3).GetHash();
+    WriteEntry(blocktree, MakeHeader(2), nTrustedHeight - 50, hashBelow);
+    WriteEntry(blocktree, MakeHeader(3), nTrustedHeight + 50, hashGood);
+
+    // Below the trusted height a tampered entry is loaded under its stored hash
+    BOOST_CHECK(blocktree.LoadBlockIndexGuts(nTrustedHeight));
+    BOOST_CHECK_EQUAL(mapBlockIndex.size(), 2U);
+    BOOST_CHECK(mapBlockIndex.count(hashBelow));
+    BOOST_CHECK_EQUAL(mapBlockIndex[hashBelow]->nNonce, 2U);
+    BOOST_CHECK(mapBlockIndex.count(hashGood));
+    ClearEntries();
+
+    // Hashing every entry catches it
+    BOOST_CHECK(!blocktree.LoadBlockIndexGuts());
+    ClearEntries();
+
+    // Above the trusted height a tampered entry fails the load
+    uint256 hashAbove = MakeHeader(4).GetHash();
+    WriteEntry(blocktree, MakeHeader(5), nTrustedHeight + 60, hashAbove);
+    BOOST_CHECK(!blocktree.LoadBlockIndexGuts(nTrustedHeight));
+    ClearEntries();
+
+    mapBlockIndex.swap(mapBlockIndexOld);
+}
+
+BOOST_AUTO_TEST_CASE(blockindex_verify_thread)
+{
+    const int nTrustedHeight = Params().LAST_POW_BLOCK() + 100;
+    BlockMap mapBlockIndexOld;
+    {
+        LOCK(cs_main);
+        mapBlockIndexOld.swap(mapBlockIndex);
+    }
+
+    // Loaded with their stored hashes: a good and a tampered entry below the trusted height, a tampered one above it
+    uint256 hashGood = MakeHeader(1).GetHash();
+    uint256 hashBelow = MakeHeader(2).GetHash();
+    uint256 hashAbove = MakeHeader(4).GetHash();
+    {
+        LOCK(cs_main);
+        InsertEntry(MakeHeader(1), nTrustedHeight - 60, hashGood);
+        InsertEntry(MakeHeader(3), nTrustedHeight - 50, hashBelow);
+        InsertEntry(MakeHeader(5), nTrustedHeight + 50, hashAbove);
+    }
+
+    std::string strMiscWarningOld = strMiscWarning;
+    strMiscWarning = "";
+    ResetBlockIndexVerifyStatus(nTrustedHeight);
+
+    UniValue r = CallRPC("getblockindexverification");
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "trustedheight").get_int(), nTrustedHeight);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "complete").get_bool(), false);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "mismatches").get_int(), 0);
+    BOOST_CHECK(find_value(r.get_obj(), "firstmismatch").isNull());
+
+    // Only the entries up to the trusted height are checked
+    ThreadVerifyBlockIndexHashes();
+    BOOST_CHECK(!strMiscWarning.empty());
+
+    r = CallRPC("getblockindexverification");
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "trustedheight").get_int(), nTrustedHeight);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "running").get_bool(), false);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "complete").get_bool(), true);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "checked").get_int(), 2);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "total").get_int(), 2);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "mismatches").get_int(), 1);
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "firstmismatch").get_str(), hashBelow.GetHex());
+
+    ResetBlockIndexVerifyStatus(-1);
+    strMiscWarning = strMiscWarningOld;
+    {
+        LOCK(cs_main);
+        ClearEntries();
+        mapBlockIndex.swap(mapBlockIndexOld);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
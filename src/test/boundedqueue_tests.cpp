@@ -0,0 +1,84 @@
+// Copyright (c) 2015-2018 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "boundedqueue.h"
+
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(boundedqueue_tests)
+
+BOOST_AUTO_TEST_CASE(boundedqueue_basics)
+{
+    CBoundedQueue<int> queue(3);
+    int n;
+
+    BOOST_CHECK(!queue.try_pop(n));
+    BOOST_CHECK(queue.try_push(1));
+    BOOST_CHECK(queue.try_push(2));
+    BOOST_CHECK(queue.try_push(3));
+    // full
+    BOOST_CHECK(!queue.try_push(4));
+    BOOST_CHECK_EQUAL(queue.size(), 3U);
+
+    BOOST_CHECK(queue.try_pop(n));
+    BOOST_CHECK_EQUAL(n, 1);
+    BOOST_CHECK(queue.try_push(4));
+
+    std::vector<int> vDrained;
+    BOOST_CHECK_EQUAL(queue.drain(vDrained, 2), 2U);
+    BOOST_CHECK(vDrained == std::vector<int>({2, 3}));
+    BOOST_CHECK_EQUAL(queue.drain(vDrained), 1U);
+    BOOST_CHECK_EQUAL(vDrained.back(), 4);
+
+    CBoundedQueue<int>::Stats stats = queue.GetStats();
+    BOOST_CHECK_EQUAL(stats.nDepth, 0U);
+    BOOST_CHECK_EQUAL(stats.nMaxDepth, 3U);
+    BOOST_CHECK_EQUAL(stats.nCapacity, 3U);
+    BOOST_CHECK_EQUAL(stats.nPushed, 4U);
+    BOOST_CHECK_EQUAL(stats.nPopped, 4U);
+    BOOST_CHECK_EQUAL(stats.nRejected, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(boundedqueue_drain_if)
+{
+    CBoundedQueue<int> queue(10);
+    for (int i = 0; i < 10; i++)
+        BOOST_CHECK(queue.try_push(i));
+
+    std::vector<int> vEven;
+    BOOST_CHECK_EQUAL(queue.drain_if(vEven, [](int i) { return i % 2 == 0; }), 5U);
+    BOOST_CHECK(vEven == std::vector<int>({0, 2, 4, 6, 8}));
+
+    // the rest keeps its order
+    int n;
+    for (int i = 1; i < 10; i += 2) {
+        BOOST_CHECK(queue.try_pop(n));
+        BOOST_CHECK_EQUAL(n, i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(boundedqueue_pop_for)
+{
+    CBoundedQueue<int> queue(10);
+    int n = 0;
+
+    BOOST_CHECK(!queue.pop_for(n, std::chrono::milliseconds(10)));
+
+    std::thread producer([&queue] { queue.try_push(42); });
+    BOOST_CHECK(queue.pop_for(n, std::chrono::seconds(10)));
+    BOOST_CHECK_EQUAL(n, 42);
+    producer.join();
+
+    // closing wakes up the consumers and refuses new work
+    bool fPopped = true;
+    std::thread consumer([&queue, &fPopped] { int m; fPopped = queue.pop_for(m, std::chrono::seconds(10)); });
+    queue.close();
+    consumer.join();
+    BOOST_CHECK(!fPopped);
+    BOOST_CHECK(!queue.try_push(1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
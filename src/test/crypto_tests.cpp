@@ -9,6 +9,7 @@
 #include "crypto/sha512.h"
 #include "crypto/hmac_sha256.h"
 #include "crypto/hmac_sha512.h"
+#include "hash.h"
 #include "random.h"
 #include "utilstrencodings.h"
 
@@ -282,4 +283,31 @@ BOOST_AUTO_TEST_CASE(rfc6979_hmac_sha256)
             ("7597887cbd76321f32e30440679a22cf7f8d9d2eac390e581fea091ce202ba94"));
 }
 
+BOOST_AUTO_TEST_CASE(sha256d64)
+{
+    const sha256_implementation::UseImplementation vUse[] = {sha256_implementation::STANDARD, sha256_implementation::USE_SSE41,
+        sha256_implementation::USE_AVX2, sha256_implementation::USE_SHANI, sha256_implementation::USE_ALL};
+    for (sha256_implementation::UseImplementation use : vUse) {
+        // Implementations the CPU lacks are skipped, the ones it has must pass their self-test
+        std::string strImplementation = SHA256AutoDetect(use);
+        BOOST_CHECK_MESSAGE(strImplementation.find("failed") == std::string::npos, strImplementation);
+
+        TestSHA256("abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        TestSHA256(std::string(1000000, 'a'),
+                   "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+        for (int i = 0; i <= 32; ++i) {
+            unsigned char in[64 * 32];
+            unsigned char out1[32 * 32], out2[32 * 32];
+            for (int j = 0; j < 64 * i; ++j)
+                in[j] = insecure_rand();
+            for (int j = 0; j < i; ++j)
+                CHash256().Write(in + 64 * j, 64).Finalize(out1 + 32 * j);
+            SHA256D64(out2, in, i);
+            BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+        }
+    }
+    SHA256AutoDetect();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "hash.h"
+#include "primitives/block.h"
+#include "random.h"
 #include "utilstrencodings.h"
 
 #include <vector>
@@ -46,4 +48,27 @@ BOOST_AUTO_TEST_CASE(murmurhash3)
 #undef T
 }
 
+BOOST_AUTO_TEST_CASE(hashquarkn)
+{
+    // Legacy Quark headers and SHA256 ones, in batches too small and large enough for the threads
+    for (size_t nHeaders : {0, 1, 15, 17, 100, 1000}) {
+        std::vector<CBlockHeader> vHeaders(nHeaders);
+        for (CBlockHeader& header : vHeaders) {
+            header.nVersion = 1 + insecure_rand() % 5;
+            header.hashPrevBlock = GetRandHash();
+            header.hashMerkleRoot = GetRandHash();
+            header.nTime = insecure_rand();
+            header.nBits = 0x1e0ffff0;
+            header.nNonce = insecure_rand();
+            header.nAccumulatorCheckpoint = GetRandHash();
+        }
+
+        std::vector<uint256> vHashes;
+        HashQuarkN(vHeaders, vHashes);
+        BOOST_CHECK_EQUAL(vHashes.size(), nHeaders);
+        for (size_t i = 0; i < nHeaders; i++)
+            BOOST_CHECK(vHashes[i] == vHeaders[i].GetHash());
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
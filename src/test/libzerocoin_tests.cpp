@@ -234,6 +234,18 @@ Test_Accumulator()
 			return false;
 		}
 
+		// Accumulating the whole list in one batch gives the same result
+		Accumulator accFive(&g_Params->accumulatorParams, CoinDenomination::ZQ_ONE);
+		std::vector<CBigNum> vValues;
+		for (uint32_t i = 0; i < TESTS_COINS_TO_ACCUMULATE; i++) {
+			vValues.push_back(gCoins[i]->getPublicCoin().getValue());
+		}
+		accFive.incrementBatch(vValues);
+		if (accOne.getValue() != accFive.getValue()) {
+			cout << "Batch accumulation doesn't match" << endl;
+			return false;
+		}
+
 		// Verify that the witness is correct
 		if (!wThree.VerifyWitness(accThree, gCoins[0]->getPublicCoin()) ) {
 			cout << "Witness not valid" << endl;
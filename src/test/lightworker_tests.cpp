@@ -0,0 +1,127 @@
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "lightzNATIVEthread.h"
+#include "net.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace libzerocoin;
+
+// Reaches the queue and the peer quota without starting the worker threads
+class CLightWorkerTest : public CLightWorker
+{
+public:
+    void SetRunning() { isWorkerRunning = true; }
+
+    using CLightWorker::popWork;
+    using CLightWorker::processWork;
+    using CLightWorker::rejectUnanswered;
+    using CLightWorker::getPeerRequests;
+};
+
+static CGenWit MakeRequest(CNode* pnode, int nHeight, CoinDenomination den, int nRequest)
+{
+    CBloomFilter filter(10, 0.01, 0, BLOOM_UPDATE_NONE);
+    CGenWit wit(filter, nHeight, den, nRequest);
+    wit.setPfrom(pnode);
+    return wit;
+}
+
+// Far above the test chain, so every request is rejected without a calculation
+static const int HEIGHT_ABOVE_CHAIN = 100000;
+
+BOOST_AUTO_TEST_SUITE(lightworker_tests)
+
+BOOST_AUTO_TEST_CASE(lightworker_join_requests)
+{
+    CLightWorkerTest worker;
+    worker.SetRunning();
+    CNode node(INVALID_SOCKET, CAddress(CService("10.0.0.1", 0)), "", true);
+
+    BOOST_CHECK(worker.addWitWork(MakeRequest(&node, HEIGHT_ABOVE_CHAIN, ZQ_TEN, 1)));
+    BOOST_CHECK(worker.addWitWork(MakeRequest(&node, HEIGHT_ABOVE_CHAIN, ZQ_FIVE, 2)));
+    BOOST_CHECK(worker.addWitWork(MakeRequest(&node, HEIGHT_ABOVE_CHAIN + 10, ZQ_TEN, 3)));
+    BOOST_CHECK(worker.addWitWork(MakeRequest(&node, HEIGHT_ABOVE_CHAIN, ZQ_TEN, 4)));
+
+    // The requests with the same denomination and starting height are calculated together, in order
+    std::vector<CGenWit> vWork;
+    BOOST_CHECK(worker.popWork(vWork, std::chrono::milliseconds(0)));
+    BOOST_CHECK_EQUAL(vWork.size(), 2U);
+    BOOST_CHECK_EQUAL(vWork[0].getRequestNum(), 1);
+    BOOST_CHECK_EQUAL(vWork[1].getRequestNum(), 4);
+    worker.processWork(vWork);
+
+    vWork.clear();
+    BOOST_CHECK(worker.popWork(vWork, std::chrono::milliseconds(0)));
+    BOOST_CHECK_EQUAL(vWork.size(), 1U);
+    BOOST_CHECK_EQUAL(vWork[0].getRequestNum(), 2);
+    worker.processWork(vWork);
+
+    vWork.clear();
+    BOOST_CHECK(worker.popWork(vWork, std::chrono::milliseconds(0)));
+    BOOST_CHECK_EQUAL(vWork.size(), 1U);
+    BOOST_CHECK_EQUAL(vWork[0].getRequestNum(), 3);
+    worker.processWork(vWork);
+
+    vWork.clear();
+    BOOST_CHECK(!worker.popWork(vWork, std::chrono::milliseconds(10)));
+    BOOST_CHECK_EQUAL(worker.getPeerRequests(node.GetId()), 0);
+}
+
+BOOST_AUTO_TEST_CASE(lightworker_peer_limit)
+{
+    CLightWorkerTest worker;
+    worker.SetRunning();
+    CNode node1(INVALID_SOCKET, CAddress(CService("10.0.0.1", 0)), "", true);
+    CNode node2(INVALID_SOCKET, CAddress(CService("10.0.0.2", 0)), "", true);
+
+    for (int i = 0; i < MAX_LIGHT_REQUESTS_PER_PEER; i++)
+        BOOST_CHECK(worker.addWitWork(MakeRequest(&node1, HEIGHT_ABOVE_CHAIN, ZQ_TEN, i)));
+    BOOST_CHECK(!worker.addWitWork(MakeRequest(&node1, HEIGHT_ABOVE_CHAIN, ZQ_TEN, MAX_LIGHT_REQUESTS_PER_PEER)));
+    BOOST_CHECK_EQUAL(worker.getPeerRequests(node1.GetId()), MAX_LIGHT_REQUESTS_PER_PEER);
+
+    // Another peer has its own quota
+    BOOST_CHECK(worker.addWitWork(MakeRequest(&node2, HEIGHT_ABOVE_CHAIN, ZQ_TEN, 0)));
+    BOOST_CHECK_EQUAL(worker.getPeerRequests(node2.GetId()), 1);
+
+    // Every answered request gives its slot back
+    std::vector<CGenWit> vWork;
+    BOOST_CHECK(worker.popWork(vWork, std::chrono::milliseconds(0)));
+    BOOST_CHECK_EQUAL(vWork.size(), (size_t)MAX_LIGHT_REQUESTS_PER_PEER + 1);
+    worker.processWork(vWork);
+    BOOST_CHECK_EQUAL(worker.getPeerRequests(node1.GetId()), 0);
+    BOOST_CHECK_EQUAL(worker.getPeerRequests(node2.GetId()), 0);
+    BOOST_CHECK(worker.addWitWork(MakeRequest(&node1, HEIGHT_ABOVE_CHAIN, ZQ_TEN, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(lightworker_reject_unanswered)
+{
+    CLightWorkerTest worker;
+    worker.SetRunning();
+    CNode node(INVALID_SOCKET, CAddress(CService("10.0.0.1", 0)), "", true);
+
+    for (int i = 0; i < 3; i++)
+        BOOST_CHECK(worker.addWitWork(MakeRequest(&node, HEIGHT_ABOVE_CHAIN, ZQ_TEN, i)));
+    BOOST_CHECK(worker.addWitWork(MakeRequest(&node, HEIGHT_ABOVE_CHAIN + 10, ZQ_TEN, 3)));
+
+    // A calculation that failed before answering rejects and releases all of its requests
+    std::vector<CGenWit> vWork;
+    BOOST_CHECK(worker.popWork(vWork, std::chrono::milliseconds(0)));
+    BOOST_CHECK_EQUAL(vWork.size(), 3U);
+    worker.rejectUnanswered(vWork);
+    BOOST_CHECK_EQUAL(worker.getPeerRequests(node.GetId()), 1);
+
+    // Answered requests are not released a second time, the queued one keeps its slot
+    worker.rejectUnanswered(vWork);
+    BOOST_CHECK_EQUAL(worker.getPeerRequests(node.GetId()), 1);
+
+    vWork.clear();
+    BOOST_CHECK(worker.popWork(vWork, std::chrono::milliseconds(0)));
+    worker.processWork(vWork);
+    worker.rejectUnanswered(vWork);
+    BOOST_CHECK_EQUAL(worker.getPeerRequests(node.GetId()), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,80 @@
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "hash.h"
+#include "primitives/block.h"
+#include "random.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(merkle_tests)
+
+// The merkle root and mutation flag, hashing one pair at a time
+static uint256 ReferenceMerkleRoot(std::vector<uint256> vHashes, bool& fMutated)
+{
+    fMutated = false;
+    while (vHashes.size() > 1) {
+        std::vector<uint256> vParents;
+        for (size_t i = 0; i < vHashes.size(); i += 2) {
+            size_t i2 = std::min(i + 1, vHashes.size() - 1);
+            if (i2 == i + 1 && i2 + 1 == vHashes.size() && vHashes[i] == vHashes[i2])
+                fMutated = true;
+            vParents.push_back(Hash(BEGIN(vHashes[i]), END(vHashes[i]), BEGIN(vHashes[i2]), END(vHashes[i2])));
+        }
+        vHashes.swap(vParents);
+    }
+    return vHashes.empty() ? uint256() : vHashes[0];
+}
+
+BOOST_AUTO_TEST_CASE(merkle_root)
+{
+    for (int nTx = 0; nTx <= 70; nTx++) {
+        CBlock block;
+        for (int i = 0; i < nTx; i++) {
+            CMutableTransaction tx;
+            tx.nLockTime = i;
+            block.vtx.push_back(CTransaction(tx));
+        }
+        std::vector<uint256> vHashes;
+        for (const CTransaction& tx : block.vtx)
+            vHashes.push_back(tx.GetHash());
+
+        bool fMutated, fMutatedRef;
+        uint256 hashRoot = ReferenceMerkleRoot(vHashes, fMutatedRef);
+        BOOST_CHECK(!fMutatedRef);
+        BOOST_CHECK(block.BuildMerkleTree(&fMutated) == hashRoot);
+        BOOST_CHECK(!fMutated);
+        BOOST_CHECK(block.GetMerkleRoot(&fMutated) == hashRoot);
+        BOOST_CHECK(!fMutated);
+
+        // Every branch of the tree leads to the root
+        for (int i = 0; i < nTx; i++)
+            BOOST_CHECK(CBlock::CheckMerkleBranch(vHashes[i], block.GetMerkleBranch(i), i) == hashRoot);
+
+        // Duplicating the end of the list keeps the root but is detected as a mutation
+        if (nTx > 1 && nTx % 2 == 1) {
+            block.vtx.push_back(block.vtx.back());
+            BOOST_CHECK(block.GetMerkleRoot(&fMutated) == hashRoot);
+            BOOST_CHECK(fMutated);
+            BOOST_CHECK(block.BuildMerkleTree(&fMutated) == hashRoot);
+            BOOST_CHECK(fMutated);
+        }
+    }
+
+    // Random leaves, with duplicates put at the end of a level
+    for (int n = 0; n < 200; n++) {
+        std::vector<uint256> vHashes(1 + insecure_rand() % 300);
+        for (uint256& hash : vHashes)
+            hash = GetRandHash();
+        if (insecure_rand() % 2 && vHashes.size() > 1)
+            vHashes.back() = vHashes[vHashes.size() - 2];
+
+        bool fMutated, fMutatedRef;
+        uint256 hashRoot = ReferenceMerkleRoot(vHashes, fMutatedRef);
+        BOOST_CHECK(CBlock::ComputeMerkleRoot(vHashes, &fMutated) == hashRoot);
+        BOOST_CHECK_EQUAL(fMutated, fMutatedRef);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+// Copyright (c) 2017-2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "zNATIVE/serialfilter.h"
+#include "chainparams.h"
+#include "libzerocoin/CoinSpend.h"
+#include "random.h"
+#include "txdb.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace libzerocoin;
+
+// Reaches the filter of an in-memory zerocoinDB
+class CZerocoinDBTest : public CZerocoinDB
+{
+public:
+    CZerocoinDBTest() : CZerocoinDB(1 << 20, true) {}
+
+    bool LoadSerialFilter(size_t nCapacity)
+    {
+        LOCK(cs_serialFilter);
+        return LoadSerialFilterInternal(nCapacity);
+    }
+
+    size_t GetFilterCapacity()
+    {
+        LOCK(cs_serialFilter);
+        return serialFilter.capacity();
+    }
+
+    // Stores a spent serial the way WriteCoinSpendBatch() does, without adding it to the filter
+    bool WriteSerialOnly(const uint256& hashSerial, const uint256& txid)
+    {
+        return Write(std::make_pair('s', hashSerial), txid);
+    }
+};
+
+// A spend with empty proofs, the zerocoinDB only looks at its serial
+static CoinSpend MakeSpend(const CBigNum& bnSerial)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params(false);
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << ZQ_ONE << uint256() << (uint32_t)0 << CBigNum(0) << CBigNum(0) << bnSerial
+       << AccumulatorProofOfKnowledge(&params->accumulatorParams)
+       << SerialNumberSignatureOfKnowledge(params)
+       << CommitmentProofOfKnowledge(&params->serialNumberSoKCommitmentGroup, &params->accumulatorParams.accumulatorPoKCommitmentGroup);
+    return CoinSpend(params, params, ss);
+}
+
+static std::vector<std::pair<CoinSpend, uint256> > MakeSpends(int nFirst, int nLast)
+{
+    std::vector<std::pair<CoinSpend, uint256> > vSpends;
+    for (int i = nFirst; i <= nLast; i++)
+        vSpends.emplace_back(MakeSpend(CBigNum(i)), GetRandHash());
+    return vSpends;
+}
+
+BOOST_AUTO_TEST_SUITE(serialfilter_tests)
+
+BOOST_AUTO_TEST_CASE(serialfilter_basics)
+{
+    CSerialFilter filter(10000);
+    std::vector<uint256> vSerials;
+    for (int i = 0; i < 10000; i++) {
+        vSerials.emplace_back(GetRandHash());
+        filter.insert(vSerials.back());
+    }
+
+    // Never a false negative
+    for (const uint256& hashSerial : vSerials)
+        BOOST_CHECK(filter.contains(hashSerial));
+    BOOST_CHECK_EQUAL(filter.size(), 10000U);
+    BOOST_CHECK(!filter.IsFull());
+
+    // About 1% false positives at capacity
+    int nFalsePositives = 0;
+    for (int i = 0; i < 10000; i++) {
+        if (filter.contains(GetRandHash()))
+            nFalsePositives++;
+    }
+    BOOST_CHECK(nFalsePositives < 200);
+
+    filter.insert(GetRandHash());
+    BOOST_CHECK(filter.IsFull());
+
+    filter.reset(20000);
+    BOOST_CHECK_EQUAL(filter.size(), 0U);
+    BOOST_CHECK_EQUAL(filter.capacity(), 20000U);
+    BOOST_CHECK(!filter.IsFull());
+    int nLeft = 0;
+    for (const uint256& hashSerial : vSerials) {
+        if (filter.contains(hashSerial))
+            nLeft++;
+    }
+    BOOST_CHECK_EQUAL(nLeft, 0);
+}
+
+BOOST_AUTO_TEST_CASE(serialfilter_zerocoindb)
+{
+    CZerocoinDBTest zerocoinDB;
+    std::vector<std::pair<CoinSpend, uint256> > vSpends = MakeSpends(1, 3);
+    BOOST_CHECK(zerocoinDB.WriteCoinSpendBatch(vSpends));
+    uint256 txid;
+
+    // Without the filter every lookup reads the database
+    uint256 hashStored = GetRandHash();
+    BOOST_CHECK(zerocoinDB.WriteSerialOnly(hashStored, GetRandHash()));
+    BOOST_CHECK(zerocoinDB.ReadCoinSpend(hashStored, txid));
+
+    // Once loaded, the spent serials are found and a serial that misses the filter is not read from the database
+    BOOST_CHECK(zerocoinDB.LoadSerialFilter(10));
+    for (const std::pair<CoinSpend, uint256>& spend : vSpends) {
+        BOOST_CHECK(zerocoinDB.ReadCoinSpend(spend.first.getCoinSerialNumber(), txid));
+        BOOST_CHECK(txid == spend.second);
+    }
+    BOOST_CHECK(zerocoinDB.ReadCoinSpend(hashStored, txid));
+    BOOST_CHECK(!zerocoinDB.ReadCoinSpend(CBigNum(100), txid));
+    uint256 hashUnfiltered = GetRandHash();
+    BOOST_CHECK(zerocoinDB.WriteSerialOnly(hashUnfiltered, GetRandHash()));
+    BOOST_CHECK(!zerocoinDB.ReadCoinSpend(hashUnfiltered, txid));
+
+    // A spend written after the load is found
+    std::vector<std::pair<CoinSpend, uint256> > vSpendsNew = MakeSpends(4, 4);
+    BOOST_CHECK(zerocoinDB.WriteCoinSpendBatch(vSpendsNew));
+    BOOST_CHECK(zerocoinDB.ReadCoinSpend(CBigNum(4), txid));
+    BOOST_CHECK(txid == vSpendsNew[0].second);
+    BOOST_CHECK_EQUAL(zerocoinDB.GetFilterCapacity(), 10U);
+
+    // Going over the capacity rebuilds the filter from the database, at twice the stored serials
+    BOOST_CHECK(zerocoinDB.WriteCoinSpendBatch(MakeSpends(5, 10)));
+    BOOST_CHECK_EQUAL(zerocoinDB.GetFilterCapacity(), 24U);
+    BOOST_CHECK(zerocoinDB.ReadCoinSpend(hashUnfiltered, txid));
+    for (int i = 1; i <= 10; i++)
+        BOOST_CHECK(zerocoinDB.ReadCoinSpend(CBigNum(i), txid));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
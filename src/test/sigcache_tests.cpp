@@ -0,0 +1,96 @@
+// Copyright (c) 2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "script/sigcache.h"
+#include "key.h"
+#include "random.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(sigcache_tests)
+
+BOOST_AUTO_TEST_CASE(sigcache_entries)
+{
+    CSignatureCache cache;
+    CKey key;
+    key.MakeNewKey(true);
+    CPubKey pubkey = key.GetPubKey();
+    uint256 hash = GetRandHash();
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(key.Sign(hash, vchSig));
+
+    // Disabled until it is sized
+    uint256 entry;
+    cache.ComputeEntry(entry, hash, vchSig, pubkey);
+    cache.Set(entry);
+    BOOST_CHECK(!cache.Get(entry));
+    BOOST_CHECK_EQUAL(cache.GetCapacity(), 0U);
+
+    cache.Setup(1 << 16);
+    BOOST_CHECK_EQUAL(cache.GetCapacity(), (1U << 16) / 32);
+    cache.Set(entry);
+    BOOST_CHECK(cache.Get(entry));
+    BOOST_CHECK_EQUAL(cache.GetEntries(), 1U);
+    cache.Set(entry);
+    BOOST_CHECK_EQUAL(cache.GetEntries(), 1U);
+
+    // Any part of the key makes another entry
+    uint256 entryOther;
+    cache.ComputeEntry(entryOther, GetRandHash(), vchSig, pubkey);
+    BOOST_CHECK(entryOther != entry);
+    BOOST_CHECK(!cache.Get(entryOther));
+    std::vector<unsigned char> vchSigOther(vchSig);
+    vchSigOther.back() ^= 1;
+    cache.ComputeEntry(entryOther, hash, vchSigOther, pubkey);
+    BOOST_CHECK(entryOther != entry);
+
+    // Another cache uses another salt
+    CSignatureCache cacheOther;
+    cacheOther.ComputeEntry(entryOther, hash, vchSig, pubkey);
+    BOOST_CHECK(entryOther != entry);
+
+    BOOST_CHECK_EQUAL(cache.GetHits(), 1U);
+    BOOST_CHECK_EQUAL(cache.GetMisses(), 2U);
+}
+
+BOOST_AUTO_TEST_CASE(sigcache_full)
+{
+    CSignatureCache cache;
+    cache.Setup(1 << 16);
+    const size_t nCapacity = cache.GetCapacity();
+
+    // Up to 90% load almost every entry finds a slot
+    std::vector<uint256> vEntries(nCapacity * 9 / 10);
+    for (uint256& entry : vEntries) {
+        entry = GetRandHash();
+        cache.Set(entry);
+    }
+    size_t nFound = 0;
+    for (const uint256& entry : vEntries)
+        nFound += cache.Get(entry);
+    BOOST_CHECK(nFound >= vEntries.size() * 99 / 100);
+    BOOST_CHECK(cache.GetEntries() >= nFound);
+
+    // Past capacity the table stays full and the latest entries are kept
+    for (size_t i = 0; i < nCapacity * 2; i++)
+        cache.Set(GetRandHash());
+    BOOST_CHECK(cache.GetEntries() <= nCapacity);
+    BOOST_CHECK(cache.GetEntries() >= nCapacity * 9 / 10);
+    std::vector<uint256> vLast(100);
+    for (uint256& entry : vLast) {
+        entry = GetRandHash();
+        cache.Set(entry);
+    }
+    nFound = 0;
+    for (const uint256& entry : vLast)
+        nFound += cache.Get(entry);
+    BOOST_CHECK(nFound >= 90);
+
+    // Resizing drops everything
+    cache.Setup(1 << 12);
+    BOOST_CHECK_EQUAL(cache.GetEntries(), 0U);
+    BOOST_CHECK(!cache.Get(vLast.back()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
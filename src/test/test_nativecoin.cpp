@@ -5,8 +5,11 @@
 
 #define BOOST_TEST_MODULE nativecoin Test Suite
 
+#include "crypto/sha256.h"
+#include "libzerocoin/SerialNumberSignatureOfKnowledge.h"
 #include "main.h"
 #include "random.h"
+#include "script/sigcache.h"
 #include "txdb.h"
 #include "ui_interface.h"
 #include "util.h"
@@ -32,7 +35,9 @@ struct TestingSetup {
     ECCVerifyHandle globalVerifyHandle;
 
     TestingSetup() {
+        SHA256AutoDetect();
         ECC_Start();
+        InitSignatureCache();
         SetupEnvironment();
         fPrintToDebugLog = false; // don't want to write to debug.log file
         fCheckBlockIndex = true;
@@ -57,6 +62,12 @@ struct TestingSetup {
         nScriptCheckThreads = 3;
         for (int i=0; i < nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        libzerocoin::nSoKVerifyThreads = 3;
+        for (int i=0; i < libzerocoin::nSoKVerifyThreads-1; i++)
+            threadGroup.create_thread(&libzerocoin::ThreadSoKVerify);
+        nZerocoinSpendCheckThreads = 3;
+        for (int i=0; i < nZerocoinSpendCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadZerocoinSpendCheck);
         RegisterNodeSignals(GetNodeSignals());
     }
     ~TestingSetup()
@@ -8,6 +8,7 @@
 #include "zNATIVE/zerocoin.h"
 #include "zNATIVE/deterministicmint.h"
 #include "zNATIVE/zNATIVEwallet.h"
+#include "zNATIVE/spendcache.h"
 #include "libzerocoin/Coin.h"
 #include "amount.h"
 #include "chainparams.h"
@@ -89,4 +90,122 @@ BOOST_AUTO_TEST_CASE(zerocoin_wrapped_serial_spend_test)
 
 }
 
+/**
+ * Check that spreading the serial number proof iterations over the worker pool
+ * accepts and rejects the same spends as verifying them on the calling thread.
+ */
+BOOST_AUTO_TEST_CASE(zerocoin_parallel_sok_verify_test)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    ZerocoinParams *ZCParams = Params().Zerocoin_Params(false);
+
+    CoinDenomination denom = CoinDenomination::ZQ_ONE;
+    PrivateCoin coinToSpend(ZCParams, denom, true);
+    PrivateCoin coinOther(ZCParams, denom, true);
+
+    Accumulator acc(&ZCParams->accumulatorParams, denom);
+    AccumulatorWitness accWitness(ZCParams, acc, coinToSpend.getPublicCoin());
+    acc += coinToSpend.getPublicCoin();
+    acc += coinOther.getPublicCoin();
+    accWitness += coinOther.getPublicCoin();
+
+    CoinSpend spend(ZCParams, ZCParams, coinToSpend, acc, 0, accWitness, 0, SpendType::SPEND);
+
+    // Flip a bit of the txout hash, which the serial number proof signs
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << spend;
+    ss[sizeof(CoinDenomination)] ^= 0x01;
+    CoinSpend tamperedSpend(ZCParams, ZCParams, ss);
+
+    int nThreadsPrev = nSoKVerifyThreads;
+    for (int nThreads : {0, 3}) {
+        nSoKVerifyThreads = nThreads;
+        BOOST_CHECK_MESSAGE(spend.Verify(acc), "Valid coinSpend rejected with " << nThreads << " threads");
+        BOOST_CHECK_MESSAGE(!tamperedSpend.Verify(acc), "Tampered coinSpend accepted with " << nThreads << " threads");
+    }
+    nSoKVerifyThreads = nThreadsPrev;
+}
+
+/**
+ * Check that a zerocoin spend check job gives the same verdict as verifying
+ * the spend directly.
+ */
+BOOST_AUTO_TEST_CASE(zerocoin_spend_check_test)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    ZerocoinParams *ZCParams = Params().Zerocoin_Params(false);
+
+    CoinDenomination denom = CoinDenomination::ZQ_FIVE;
+    PrivateCoin coinToSpend(ZCParams, denom, true);
+    PrivateCoin coinOther(ZCParams, denom, true);
+
+    Accumulator acc(&ZCParams->accumulatorParams, denom);
+    AccumulatorWitness accWitness(ZCParams, acc, coinToSpend.getPublicCoin());
+    acc += coinToSpend.getPublicCoin();
+    acc += coinOther.getPublicCoin();
+    accWitness += coinOther.getPublicCoin();
+
+    CoinSpend spend(ZCParams, ZCParams, coinToSpend, acc, 0, accWitness, 0, SpendType::SPEND);
+
+    CZerocoinSpendCheck check(spend, ZCParams, acc.getValue(), true);
+    BOOST_CHECK_MESSAGE(check(), "Valid coinSpend rejected by CZerocoinSpendCheck");
+
+    // Swapped into a queue slot, the job must still carry the spend
+    CZerocoinSpendCheck checkSwapped;
+    checkSwapped.swap(check);
+    BOOST_CHECK_MESSAGE(checkSwapped(), "Swapped CZerocoinSpendCheck lost its spend");
+
+    // The spend was not accumulated in a different accumulator
+    Accumulator accOther(&ZCParams->accumulatorParams, denom);
+    accOther += coinOther.getPublicCoin();
+    CZerocoinSpendCheck checkWrongAcc(spend, ZCParams, accOther.getValue(), true);
+    BOOST_CHECK_MESSAGE(!checkWrongAcc(), "coinSpend accepted against the wrong accumulator");
+}
+
+/**
+ * Check that the validated spend cache only answers for the exact spend and
+ * accumulator that were verified.
+ */
+BOOST_AUTO_TEST_CASE(zerocoin_spend_cache_test)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    ZerocoinParams *ZCParams = Params().Zerocoin_Params(false);
+
+    CoinDenomination denom = CoinDenomination::ZQ_TEN;
+    PrivateCoin coinToSpend(ZCParams, denom, true);
+    PrivateCoin coinOther(ZCParams, denom, true);
+
+    Accumulator acc(&ZCParams->accumulatorParams, denom);
+    AccumulatorWitness accWitness(ZCParams, acc, coinToSpend.getPublicCoin());
+    acc += coinToSpend.getPublicCoin();
+    acc += coinOther.getPublicCoin();
+    accWitness += coinOther.getPublicCoin();
+
+    CoinSpend spend(ZCParams, ZCParams, coinToSpend, acc, 0, accWitness, 0, SpendType::SPEND);
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << spend;
+    ss[sizeof(CoinDenomination)] ^= 0x01;
+    CoinSpend tamperedSpend(ZCParams, ZCParams, ss);
+
+    Accumulator accOther(&ZCParams->accumulatorParams, denom);
+    accOther += coinOther.getPublicCoin();
+
+    // The same spend read with the V1 params for its accumulator proof, the way it is read below the V2 start height
+    ZerocoinParams *ZCParamsV1 = Params().Zerocoin_Params(true);
+    BOOST_CHECK(ZCParamsV1->accumulatorParams.accumulatorModulus != ZCParams->accumulatorParams.accumulatorModulus);
+    CDataStream ssV1(SER_NETWORK, PROTOCOL_VERSION);
+    ssV1 << spend;
+    CoinSpend spendV1(ZCParamsV1, ZCParamsV1, ssV1);
+    BOOST_CHECK(!spendV1.Verify(acc, true));
+
+    // Twice each: the second call of a valid spend is answered by the cache
+    for (int i = 0; i < 2; i++) {
+        BOOST_CHECK_MESSAGE(VerifyZerocoinSpendCached(spend, acc, true), "Valid coinSpend rejected, pass " << i);
+        BOOST_CHECK_MESSAGE(!VerifyZerocoinSpendCached(tamperedSpend, acc, true), "Tampered coinSpend accepted, pass " << i);
+        BOOST_CHECK_MESSAGE(!VerifyZerocoinSpendCached(spend, accOther, true), "coinSpend accepted against the wrong accumulator, pass " << i);
+        BOOST_CHECK_MESSAGE(!VerifyZerocoinSpendCached(spendV1, acc, true), "coinSpend accepted with the V1 params, pass " << i);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,7 @@
 #include "key.h"
 #include "zNATIVE/accumulatorcheckpoints.h"
 #include "libzerocoin/bignum.h"
+#include "libzerocoin/ParamGeneration.h"
 #include <boost/test/unit_test.hpp>
 #include <iostream>
 #include <zNATIVE/accumulators.h>
@@ -40,6 +41,33 @@ BOOST_AUTO_TEST_CASE(zcparams_test)
     BOOST_CHECK(fPassed);
 }
 
+BOOST_AUTO_TEST_CASE(zerocoin_params_cache)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    for (bool fModulusV1 : {true, false}) {
+        const ZerocoinParams* params = Params().Zerocoin_Params(fModulusV1);
+        CBigNum N = params->accumulatorParams.accumulatorModulus;
+
+        // The chain moduli are in the cache, other inputs are not
+        ZerocoinParams cached(*params);
+        BOOST_CHECK(LoadCachedGroups(cached, N, ZEROCOIN_PROTOCOL_VERSION, ZEROCOIN_DEFAULT_SECURITYLEVEL));
+        ZerocoinParams uncached(*params);
+        BOOST_CHECK(!LoadCachedGroups(uncached, N, "2", ZEROCOIN_DEFAULT_SECURITYLEVEL));
+        BOOST_CHECK(!LoadCachedGroups(uncached, N, ZEROCOIN_PROTOCOL_VERSION, ZEROCOIN_DEFAULT_SECURITYLEVEL + 1));
+
+        // and the cached groups are the ones the slow derivation finds
+        ZerocoinParams derived(*params);
+        CalculateGroups(derived, N, ZEROCOIN_PROTOCOL_VERSION, ZEROCOIN_DEFAULT_SECURITYLEVEL);
+        std::string strGroups = SerializeCachedGroups(derived);
+        uint256 key = calculateParamsCacheKey(N, ZEROCOIN_PROTOCOL_VERSION, ZEROCOIN_DEFAULT_SECURITYLEVEL);
+        CHashWriter hasher(0, 0);
+        hasher << key << ParseHex(strGroups);
+        BOOST_CHECK_MESSAGE(SerializeCachedGroups(cached) == strGroups,
+                "libzerocoin/ParamsCache.h is out of date, key=" << key.GetHex() <<
+                " checksum=" << hasher.GetHash().GetHex() << " groups=" << strGroups);
+    }
+}
+
 std::string zerocoinModulus = "25195908475657893494027183240048398571429282126204032027777137836043662020707595556264018525880784"
 "4069182906412495150821892985591491761845028084891200728449926873928072877767359714183472702618963750149718246911"
 "6507761337985909570009733045974880842840179742910064245869181719511874612151517265463228221686998754918242243363"
@@ -88,6 +116,90 @@ BOOST_AUTO_TEST_CASE(bignum_basic_tests)
     BOOST_CHECK_MESSAGE(bn2 == bn, "CBigNum.setvch() or CBigNum.getvch() does not work correctly");
 }
 
+BOOST_AUTO_TEST_CASE(fixedbase_pow_mod_test)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    ZerocoinParams *ZCParams = Params().Zerocoin_Params(false);
+
+    std::vector<IntegerGroupParams*> vGroups = {&ZCParams->coinCommitmentGroup,
+                                                &ZCParams->serialNumberSoKCommitmentGroup,
+                                                &ZCParams->accumulatorParams.accumulatorPoKCommitmentGroup};
+    for (IntegerGroupParams* group : vGroups) {
+        BOOST_CHECK(!group->gPowers.IsNull() && !group->hPowers.IsNull());
+        for (int i = 0; i < 4; i++) {
+            CBigNum e = CBigNum::randBignum(group->groupOrder);
+            BOOST_CHECK(group->gPowers.pow_mod(e) == group->g.pow_mod(e, group->modulus));
+            BOOST_CHECK(group->hPowers.pow_mod(-e) == group->h.pow_mod(-e, group->modulus));
+            // exponents longer than the group order are reduced first
+            CBigNum eLong = CBigNum::RandKBitBigum(group->groupOrder.bitSize() + 64);
+            BOOST_CHECK(group->hPowers.pow_mod(eLong) == group->h.pow_mod(eLong, group->modulus));
+        }
+        BOOST_CHECK(group->gPowers.pow_mod(CBigNum(0)) == CBigNum(1));
+
+        CBigNum bnResult = CBigNum::randBignum(group->groupOrder);
+        CBigNum bnExpected = group->g.pow_mod(bnResult, group->modulus);
+        group->gPowers.pow_mod_into(bnResult, bnResult);
+        BOOST_CHECK(bnResult == bnExpected);
+    }
+
+    // the QRN group has a hidden order, oversize exponents fall back to CBigNum::pow_mod
+    IntegerGroupParams& qrn = ZCParams->accumulatorParams.accumulatorQRNCommitmentGroup;
+    const CBigNum& N = ZCParams->accumulatorParams.accumulatorModulus;
+    CBigNum e = CBigNum::RandKBitBigum(N.bitSize() + ZCParams->accumulatorParams.k_prime);
+    BOOST_CHECK(qrn.gPowers.pow_mod(e) == qrn.g.pow_mod(e, N));
+    BOOST_CHECK(qrn.hPowers.pow_mod(-e) == qrn.h.pow_mod(-e, N));
+    CBigNum eHuge = CBigNum::RandKBitBigum(2 * N.bitSize() + 64);
+    BOOST_CHECK(qrn.gPowers.pow_mod(eHuge) == qrn.g.pow_mod(eHuge, N));
+}
+
+BOOST_AUTO_TEST_CASE(multi_pow_mod_test)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    ZerocoinParams *ZCParams = Params().Zerocoin_Params(false);
+    const CBigNum& N = ZCParams->accumulatorParams.accumulatorModulus;
+
+    std::vector<CBigNum> vBases, vExps;
+    CBigNum bnExpected(1);
+    for (int i = 0; i < 3; i++) {
+        CBigNum base = CBigNum::randBignum(N);
+        CBigNum exp = CBigNum::RandKBitBigum(256 << i);
+        if (i == 1)
+            exp = -exp;
+        vBases.push_back(base);
+        vExps.push_back(exp);
+        bnExpected = bnExpected.mul_mod(base.pow_mod(exp, N), N);
+        BOOST_CHECK(CBigNum::multi_pow_mod(vBases, vExps, N) == bnExpected);
+    }
+
+    // zero exponents and an empty product
+    BOOST_CHECK(CBigNum::multi_pow_mod({vBases[0], vBases[1]}, {CBigNum(0), vExps[1]}, N) == vBases[1].pow_mod(vExps[1], N));
+    BOOST_CHECK(CBigNum::multi_pow_mod({}, {}, N) == CBigNum(1));
+}
+
+BOOST_AUTO_TEST_CASE(bignum_inplace_tests)
+{
+    CBigNum m, a, b;
+    m.SetHex(strHexModulus);
+    a.SetHex(str_a);
+    b.SetHex(str_b);
+
+    CBigNum bnExpected = a.mul_mod(b, m);
+    CBigNum bnResult = a;
+    BOOST_CHECK(bnResult.mul_mod_inplace(b, m) == bnExpected);
+    BOOST_CHECK(bnResult.mul_mod_inplace(bnResult, m) == bnExpected.mul_mod(bnExpected, m));
+
+    // the result may alias the base or the exponent
+    bnExpected = a.pow_mod(a, m);
+    a.pow_mod_into(bnResult, a, m);
+    BOOST_CHECK(bnResult == bnExpected);
+    bnResult = a;
+    bnResult.pow_mod_into(bnResult, bnResult, m);
+    BOOST_CHECK(bnResult == bnExpected);
+    bnResult = b;
+    a.pow_mod_into(bnResult, bnResult, m);
+    BOOST_CHECK(bnResult == a.pow_mod(b, m));
+}
+
 //ZQ_ONE mints
 std::string rawTx1 = "0100000001983d5fd91685bb726c0ebc3676f89101b16e663fd896fea53e19972b95054c49000000006a473044022010fbec3e78f9c46e58193d481caff715ceb984df44671d30a2c0bde95c54055f0220446a97d9340da690eaf2658e5b2bf6a0add06f1ae3f1b40f37614c7079ce450d012103cb666bd0f32b71cbf4f32e95fa58e05cd83869ac101435fcb8acee99123ccd1dffffffff0200e1f5050000000086c10280004c80c3a01f94e71662f2ae8bfcd88dfc5b5e717136facd6538829db0c7f01e5fd793cccae7aa1958564518e0223d6d9ce15b1e38e757583546e3b9a3f85bd14408120cd5192a901bb52152e8759fdd194df230d78477706d0e412a66398f330be38a23540d12ab147e9fb19224913f3fe552ae6a587fb30a68743e52577150ff73042c0f0d8f000000001976a914d6042025bd1fff4da5da5c432d85d82b3f26a01688ac00000000";
 std::string rawTxpub1 = "473ff507157523e74680ab37f586aae52e53f3f912492b19f7e14ab120d54238ae30b338f39662a410e6d707784d730f24d19dd9f75e85221b51b902a19d50c120844d15bf8a3b9e346355857e7381e5be19c6d3d22e01845565819aae7cacc93d75f1ef0c7b09d823865cdfa3671715e5bfc8dd8fc8baef26216e7941fa0c3";
@@ -146,6 +258,48 @@ BOOST_AUTO_TEST_CASE(checkzerocoinmint_test)
     BOOST_CHECK(fFoundMint);
 }
 
+BOOST_AUTO_TEST_CASE(block_pubcoin_index_test)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    CBlock block;
+    for (auto& raw : vecRawMints) {
+        CTransaction tx;
+        BOOST_CHECK(DecodeHexTx(tx, raw.first));
+        block.vtx.emplace_back(tx);
+    }
+
+    std::list<PublicCoin> listPubcoins;
+    BOOST_CHECK(BlockToPubcoinList(block, listPubcoins, true));
+    std::vector<CBlockPubcoin> vPubcoins;
+    BOOST_CHECK(BlockToPubcoinIndex(block, vPubcoins));
+    BOOST_CHECK_EQUAL(vPubcoins.size(), listPubcoins.size());
+    BOOST_CHECK_EQUAL(vPubcoins.size(), vecRawMints.size());
+
+    auto it = listPubcoins.begin();
+    for (const CBlockPubcoin& mint : vPubcoins) {
+        BOOST_CHECK(mint.fValidOutPoint);
+        BOOST_CHECK(mint.denom == it->getDenomination());
+        BOOST_CHECK(mint.bnValue == it->getValue());
+        ++it;
+    }
+
+    // the index is keyed by block hash and survives a round trip through the db
+    CZerocoinDB db(1 << 20, true);
+    uint256 hashBlock = block.GetHash();
+    std::vector<CBlockPubcoin> vRead;
+    BOOST_CHECK(!db.ReadBlockPubcoins(hashBlock, vRead));
+    BOOST_CHECK(db.WriteBlockPubcoins(hashBlock, vPubcoins));
+    BOOST_CHECK(db.ReadBlockPubcoins(hashBlock, vRead));
+    BOOST_CHECK_EQUAL(vRead.size(), vPubcoins.size());
+    for (unsigned int i = 0; i < vRead.size(); i++) {
+        BOOST_CHECK(vRead[i].denom == vPubcoins[i].denom);
+        BOOST_CHECK(vRead[i].bnValue == vPubcoins[i].bnValue);
+        BOOST_CHECK(vRead[i].fValidOutPoint == vPubcoins[i].fValidOutPoint);
+    }
+    BOOST_CHECK(db.EraseBlockPubcoins(hashBlock));
+    BOOST_CHECK(!db.ReadBlockPubcoins(hashBlock, vRead));
+}
+
 bool CheckZerocoinSpendNoDB(const CTransaction tx, string& strError)
 {
     //max needed non-mint outputs should be 2 - one for redemption address and a possible 2nd for change
@@ -341,6 +495,27 @@ BOOST_AUTO_TEST_CASE(checkzerocoinspend_test)
     txNew.vin.push_back(newTxIn);
     txNew.vout.push_back(txOut);
 
+    // the serial index of a block with the spend
+    CBlock blockSpend;
+    blockSpend.vtx.emplace_back(txNew);
+    std::vector<CBlockSerial> vSerials;
+    BOOST_CHECK(BlockToSerialIndex(blockSpend, vSerials));
+    BOOST_CHECK_EQUAL(vSerials.size(), 1U);
+    BOOST_CHECK(vSerials[0].bnSerial == serial);
+    BOOST_CHECK(vSerials[0].denom == denom);
+    BOOST_CHECK(vSerials[0].txid == txNew.GetHash());
+    BOOST_CHECK(vSerials[0].txoutSpentTo == txOut);
+
+    CZerocoinDB db(1 << 20, true);
+    std::vector<CBlockSerial> vRead;
+    BOOST_CHECK(db.WriteBlockSerials(blockSpend.GetHash(), vSerials));
+    BOOST_CHECK(db.ReadBlockSerials(blockSpend.GetHash(), vRead));
+    BOOST_CHECK_EQUAL(vRead.size(), 1U);
+    BOOST_CHECK(vRead[0].bnSerial == serial);
+    BOOST_CHECK(vRead[0].txoutSpentTo == txOut);
+    BOOST_CHECK(db.EraseBlockSerials(blockSpend.GetHash()));
+    BOOST_CHECK(!db.ReadBlockSerials(blockSpend.GetHash(), vRead));
+
     CTransaction txMintFrom;
     BOOST_CHECK_MESSAGE(DecodeHexTx(txMintFrom, rawTx1), "Failed to deserialize hex transaction");
 
@@ -545,5 +720,152 @@ BOOST_AUTO_TEST_CASE(deterministic_tests)
     BOOST_CHECK_MESSAGE(hash == uint256("c90c225f2cbdee5ef053b1f9f70053dd83724c58126d0e1b8425b88091d1f73f"), "minting determinism isn't as expected");
 }
 
+BOOST_AUTO_TEST_CASE(mint_pool_count_test)
+{
+    CMintPool pool;
+    CBigNum bnValueA(1001), bnValueB(1002), bnValueC(1003);
+    pool.Add(bnValueA, 1);
+    pool.Add(bnValueB, 2);
+    BOOST_CHECK(pool.HasCount(1));
+    BOOST_CHECK(pool.HasCount(2));
+    BOOST_CHECK(!pool.HasCount(3));
+    BOOST_CHECK_EQUAL(pool.CountOfLastGenerated(), 2U);
+
+    // Removing a mint frees its count
+    pool.Remove(bnValueA);
+    BOOST_CHECK(!pool.HasCount(1));
+    BOOST_CHECK(pool.HasCount(2));
+    BOOST_CHECK_EQUAL(pool.CountOfLastRemoved(), 1U);
+
+    // A count that was added again for another value stays taken when the old value is removed
+    pool.Add(bnValueC, 2);
+    pool.Remove(bnValueB);
+    BOOST_CHECK(pool.HasCount(2));
+    pool.Remove(bnValueC);
+    BOOST_CHECK(!pool.HasCount(2));
+
+    pool.Add(bnValueA, 1);
+    pool.Reset();
+    BOOST_CHECK(!pool.HasCount(1));
+    BOOST_CHECK(pool.empty());
+}
+
+BOOST_AUTO_TEST_CASE(mint_pool_generation_test)
+{
+    SelectParams(CBaseChainParams::UNITTEST);
+    uint256 seedMaster("3a1947364362e2e7c073b386869c89c905c0cf462448ffd6c2021bd03ce689f6");
+    uint256 hashSeed = Hash(seedMaster.begin(), seedMaster.end());
+
+    string strWalletFile = "unittestwallet.dat";
+    CWalletDB walletdb(strWalletFile, "cr+");
+    CzNATIVEWallet zWallet(strWalletFile);
+    zWallet.SetMasterSeed(seedMaster);
+
+    // The pool generated on every core and stored in one transaction
+    const uint32_t nMints = 8;
+    BOOST_CHECK(zWallet.GenerateMintPool(1, nMints));
+    int nCount, nLastGenerated;
+    zWallet.GetState(nCount, nLastGenerated);
+    BOOST_CHECK_EQUAL(nLastGenerated, (int)nMints);
+
+    // Every count was stored
+    std::set<uint32_t> setStored;
+    for (auto& pair : walletdb.MapMintPool()[hashSeed])
+        setStored.insert(pair.second);
+    for (uint32_t n = 1; n <= nMints; n++)
+        BOOST_CHECK(setStored.count(n));
+
+    // It holds the same mints as the serial path generates one by one
+    for (uint32_t n = 1; n <= nMints; n++) {
+        PrivateCoin coin(Params().Zerocoin_Params(false), ZQ_ONE, false);
+        CDeterministicMint dMint;
+        zWallet.GenerateMint(n, ZQ_ONE, coin, dMint);
+        BOOST_CHECK(zWallet.IsInMintPool(coin.getPublicCoin().getValue()));
+    }
+
+    // Counts already in the pool are not generated again
+    BOOST_CHECK(zWallet.GenerateMintPool(1, nMints));
+    zWallet.GetState(nCount, nLastGenerated);
+    BOOST_CHECK_EQUAL(nLastGenerated, (int)nMints);
+}
+
+//the chain walk GetMintMaturityHeight() used before it kept running counts
+static std::map<CoinDenomination, int> WalkMintMaturityHeight()
+{
+    std::map<CoinDenomination, std::pair<int, int> > mapDenomMaturity;
+    for (auto denom : zerocoinDenomList)
+        mapDenomMaturity.insert(std::make_pair(denom, std::make_pair(0, 0)));
+
+    int nConfirmedHeight = chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations();
+    int nMinimumMaturityHeight = nConfirmedHeight - (nConfirmedHeight % 10);
+    CBlockIndex* pindex = chainActive[nConfirmedHeight];
+    while (pindex && pindex->nHeight > Params().Zerocoin_StartHeight()) {
+        for (auto denom : zerocoinDenomList) {
+            if (mapDenomMaturity.at(denom).first < Params().Zerocoin_RequiredAccumulation()) {
+                mapDenomMaturity.at(denom).first += count(pindex->vMintDenominationsInBlock.begin(), pindex->vMintDenominationsInBlock.end(), denom);
+                if (mapDenomMaturity.at(denom).first >= Params().Zerocoin_RequiredAccumulation())
+                    mapDenomMaturity.at(denom).second = std::min(pindex->nHeight, nMinimumMaturityHeight);
+            }
+        }
+        pindex = chainActive[pindex->nHeight - 1];
+    }
+
+    std::map<CoinDenomination, int> mapRet;
+    for (auto denom : zerocoinDenomList)
+        mapRet.insert(std::make_pair(denom, mapDenomMaturity.at(denom).second));
+    return mapRet;
+}
+
+BOOST_AUTO_TEST_CASE(mint_maturity_test)
+{
+    SelectParams(CBaseChainParams::UNITTEST);
+    ModifiableParams()->setZerocoinStartHeight(50);
+    CBlockIndex* pindexTipOld = chainActive.Tip();
+
+    // a chain whose rarer denominations get a mint every few dozen blocks
+    std::vector<CBlockIndex*> vBlocks;
+    auto extend = [&vBlocks](CBlockIndex* pprev, int nBlocks) {
+        for (int i = 0; i < nBlocks; i++) {
+            CBlockIndex* pindex = new CBlockIndex();
+            pindex->pprev = pprev;
+            pindex->nHeight = pprev ? pprev->nHeight + 1 : 0;
+            for (auto denom : zerocoinDenomList) {
+                if (insecure_rand() % (5 * ZerocoinDenominationToInt(denom)) == 0)
+                    pindex->vMintDenominationsInBlock.emplace_back(denom);
+            }
+            vBlocks.emplace_back(pindex);
+            pprev = pindex;
+        }
+        return pprev;
+    };
+
+    CBlockIndex* pindexTip = extend(nullptr, 300);
+    chainActive.SetTip(pindexTip);
+    BOOST_CHECK(GetMintMaturityHeight() == WalkMintMaturityHeight());
+
+    // growing the chain only counts the new blocks
+    pindexTip = extend(pindexTip, 150);
+    chainActive.SetTip(pindexTip);
+    BOOST_CHECK(GetMintMaturityHeight() == WalkMintMaturityHeight());
+
+    // a reorg to a branch from below the confirmed height drops the counts of the old branch
+    CBlockIndex* pindexFork = extend(chainActive[380], 40);
+    chainActive.SetTip(pindexFork);
+    BOOST_CHECK(GetMintMaturityHeight() == WalkMintMaturityHeight());
+    chainActive.SetTip(pindexTip);
+    BOOST_CHECK(GetMintMaturityHeight() == WalkMintMaturityHeight());
+
+    // a chain that does not reach the confirmations has nothing mature
+    chainActive.SetTip(chainActive[60]);
+    for (auto& denomHeight : GetMintMaturityHeight())
+        BOOST_CHECK_EQUAL(denomHeight.second, 0);
+
+    // the cache points at the blocks deleted below
+    chainActive.SetTip(pindexTipOld);
+    ResetMintMaturityCache();
+    ModifiableParams()->setZerocoinStartHeight(INT_MAX);
+    for (CBlockIndex* pindex : vBlocks)
+        delete pindex;
+}
 
 BOOST_AUTO_TEST_SUITE_END()
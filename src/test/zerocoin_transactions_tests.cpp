@@ -10,6 +10,7 @@
 #include "wallet/wallet.h"
 #include "wallet/walletdb.h"
 #include "txdb.h"
+#include "zNATIVE/accumulators.h"
 #include <boost/test/unit_test.hpp>
 #include <iostream>
 
@@ -53,4 +54,114 @@ BOOST_AUTO_TEST_CASE(zerocoin_spend_test)
 
 }
 
+BOOST_AUTO_TEST_CASE(zerocoin_tracker_index_test)
+{
+    CzNATIVETracker tracker(cWallet.strWalletFile);
+
+    // Mints of every denomination at different heights, unconfirmed ones and spent ones
+    std::vector<CZerocoinMint> vMints;
+    for (int i = 0; i < 48; i++) {
+        CoinDenomination denom = zerocoinDenomList[i % zerocoinDenomList.size()];
+        CZerocoinMint mint(denom, CBigNum::randBignum(CBigNum(1) << 256), CBigNum::randBignum(CBigNum(1) << 256),
+                CBigNum::randBignum(CBigNum(1) << 240), i % 5 == 0, 1);
+        mint.SetHeight(i % 7 == 0 ? 0 : i * 3);
+        tracker.Add(mint);
+        vMints.emplace_back(mint);
+    }
+
+    // The indexed views must list the same mints as a scan of every mint
+    std::map<CoinDenomination, int> mapMaturity = GetMintMaturityHeight();
+    int nConfirmedHeight = chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations();
+    std::set<uint256> setUnused, setMature;
+    CAmount nBalance = 0;
+    for (const CZerocoinMint& mint : vMints) {
+        if (mint.IsUsed())
+            continue;
+        uint256 hashPubcoin = GetPubCoinHash(mint.GetValue());
+        setUnused.insert(hashPubcoin);
+        nBalance += ZerocoinDenominationToAmount(mint.GetDenomination());
+        if (mint.GetHeight() && mint.GetHeight() <= nConfirmedHeight && mint.GetHeight() < mapMaturity.at(mint.GetDenomination()))
+            setMature.insert(hashPubcoin);
+    }
+
+    auto ListHashes = [&](bool fMatureOnly) {
+        std::set<uint256> setHashes;
+        for (const CMintMeta& meta : tracker.ListMints(true, fMatureOnly, false))
+            setHashes.insert(meta.hashPubcoin);
+        return setHashes;
+    };
+    BOOST_CHECK(ListHashes(false) == setUnused);
+    BOOST_CHECK(ListHashes(true) == setMature);
+    BOOST_CHECK_EQUAL(tracker.GetBalance(false, false), nBalance);
+    BOOST_CHECK_EQUAL(tracker.GetMints(false).size(), setUnused.size());
+    BOOST_CHECK_EQUAL(tracker.ListMints(false, false, false).size(), vMints.size());
+
+    for (const CZerocoinMint& mint : vMints) {
+        uint256 hashPubcoin = GetPubCoinHash(mint.GetValue());
+        BOOST_CHECK(tracker.HasPubcoinHash(hashPubcoin));
+        CMintMeta meta = tracker.GetMetaFromPubcoin(hashPubcoin);
+        BOOST_CHECK(meta.hashSerial == GetSerialHash(mint.GetSerialNumber()));
+
+        CMintMeta metaStake;
+        BOOST_CHECK(tracker.GetMetaFromStakeHash(meta.hashStake, metaStake));
+        BOOST_CHECK(metaStake.hashPubcoin == hashPubcoin);
+    }
+
+    // A mint that changes state moves out of the unused index
+    CZerocoinMint mintSpent = vMints[1];
+    mintSpent.SetUsed(true);
+    tracker.Add(mintSpent);
+    setUnused.erase(GetPubCoinHash(mintSpent.GetValue()));
+    nBalance -= ZerocoinDenominationToAmount(mintSpent.GetDenomination());
+    BOOST_CHECK(ListHashes(false) == setUnused);
+    BOOST_CHECK_EQUAL(tracker.GetBalance(false, false), nBalance);
+    BOOST_CHECK(tracker.HasPubcoinHash(GetPubCoinHash(mintSpent.GetValue())));
+
+    tracker.Clear();
+    BOOST_CHECK(tracker.ListMints(true, false, false).empty());
+    BOOST_CHECK(!tracker.HasPubcoinHash(GetPubCoinHash(vMints[2].GetValue())));
+}
+
+BOOST_AUTO_TEST_CASE(zerocoin_persisted_witness_test)
+{
+    ZerocoinParams* params = Params().Zerocoin_Params(false);
+    CZerocoinMint mint(ZQ_TEN, CBigNum::randBignum(params->coinCommitmentGroup.modulus), CBigNum::randBignum(CBigNum(1) << 256),
+            CBigNum::randBignum(CBigNum(1) << 240), false, 1);
+    mint.SetHeight(105);
+    uint256 hashStake = GetSerialHash(mint.GetSerialNumber());
+
+    // The precomputer advanced the witness up to height 150 and persisted it
+    CoinWitnessData witness(mint);
+    witness.SetHeightMintAdded(mint.GetHeight());
+    witness.pAccumulator = std::unique_ptr<Accumulator>(new Accumulator(params, ZQ_TEN, CBigNum::randBignum(params->accumulatorParams.accumulatorModulus)));
+    witness.nHeightAccEnd = 150;
+    witness.nMintsAdded = 12;
+    BOOST_CHECK(CWalletDB("precomputes.dat", "cr+").WritePrecompute(hashStake, CoinWitnessCacheData(&witness)));
+
+    // A spend with an empty spend cache continues from the persisted witness
+    LOCK(cWallet.zNATIVETracker->cs_spendcache);
+    cWallet.zNATIVETracker->ClearSpendCache();
+    CoinWitnessData* coinWitness = cWallet.zNATIVETracker->GetSpendCache(hashStake);
+    BOOST_CHECK_EQUAL(coinWitness->nHeightAccEnd, 0);
+    cWallet.LoadSpendWitness(mint, hashStake, coinWitness);
+    BOOST_CHECK_EQUAL(coinWitness->nHeightAccStart, witness.nHeightAccStart);
+    BOOST_CHECK_EQUAL(coinWitness->nHeightAccEnd, 150);
+    BOOST_CHECK_EQUAL(coinWitness->nMintsAdded, 12);
+    BOOST_CHECK(coinWitness->coin->getValue() == mint.GetValue());
+    BOOST_CHECK(coinWitness->pAccumulator->getValue() == witness.pAccumulator->getValue());
+
+    // A witness persisted for another coin is not used, the witness starts at the mint
+    CZerocoinMint mintOther = mint;
+    mintOther.SetValue(CBigNum::randBignum(params->coinCommitmentGroup.modulus));
+    cWallet.zNATIVETracker->ClearSpendCache();
+    coinWitness = cWallet.zNATIVETracker->GetSpendCache(hashStake);
+    cWallet.LoadSpendWitness(mintOther, hashStake, coinWitness);
+    BOOST_CHECK_EQUAL(coinWitness->nHeightAccEnd, 0);
+    BOOST_CHECK_EQUAL(coinWitness->nHeightMintAdded, 105);
+    BOOST_CHECK(coinWitness->coin->getValue() == mintOther.GetValue());
+
+    BOOST_CHECK(CWalletDB("precomputes.dat", "cr+").ErasePrecompute(hashStake));
+    cWallet.zNATIVETracker->ClearSpendCache();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
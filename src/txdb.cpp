@@ -208,7 +208,7 @@ bool CBlockTreeDB::ReadInt(const std::string& name, int& nValue)
     return Read(std::make_pair('I', name), nValue);
 }
 
-bool CBlockTreeDB::LoadBlockIndexGuts()
+bool CBlockTreeDB::LoadBlockIndexGuts(int nTrustedHeight)
 {
     boost::scoped_ptr<leveldb::Iterator> pcursor(NewIterator());
 
@@ -216,82 +216,161 @@ bool CBlockTreeDB::LoadBlockIndexGuts()
     ssKeySet << make_pair('b', uint256(0));
     pcursor->Seek(ssKeySet.str());
 
-    // Load mapBlockIndex
+    // Load mapBlockIndex, the hashes of each batch of entries are checked at once
     uint256 nPreviousCheckpoint;
-    while (pcursor->Valid()) {
+    std::vector<CDiskBlockIndex> vDiskIndex;
+    std::vector<uint256> vKeyHashes;
+    std::vector<size_t> vUntrusted;
+    std::vector<CBlockHeader> vHeaders;
+    std::vector<uint256> vHashes;
+    bool fDone = false;
+    while (!fDone) {
         boost::this_thread::interruption_point();
-        try {
-            leveldb::Slice slKey = pcursor->key();
-            CDataStream ssKey(slKey.data(), slKey.data() + slKey.size(), SER_DISK, CLIENT_VERSION);
-            char chType;
-            ssKey >> chType;
-            if (chType == 'b') {
+        vDiskIndex.clear();
+        vKeyHashes.clear();
+        while (vDiskIndex.size() < BLOCK_INDEX_LOAD_BATCH_SIZE) {
+            if (!pcursor->Valid()) {
+                fDone = true;
+                break;
+            }
+            try {
+                leveldb::Slice slKey = pcursor->key();
+                CDataStream ssKey(slKey.data(), slKey.data() + slKey.size(), SER_DISK, CLIENT_VERSION);
+                char chType;
+                ssKey >> chType;
+                if (chType != 'b') {
+                    fDone = true; // finished loading block index
+                    break;
+                }
+                vKeyHashes.emplace_back();
+                ssKey >> vKeyHashes.back();
                 leveldb::Slice slValue = pcursor->value();
                 CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
-                CDiskBlockIndex diskindex;
-                ssValue >> diskindex;
-
-                // Construct block index object
-                CBlockIndex* pindexNew = InsertBlockIndex(diskindex.GetBlockHash());
-                pindexNew->pprev = InsertBlockIndex(diskindex.hashPrev);
-                pindexNew->pnext = InsertBlockIndex(diskindex.hashNext);
-                pindexNew->nHeight = diskindex.nHeight;
-                pindexNew->nFile = diskindex.nFile;
-                pindexNew->nDataPos = diskindex.nDataPos;
-                pindexNew->nUndoPos = diskindex.nUndoPos;
-                pindexNew->nVersion = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime = diskindex.nTime;
-                pindexNew->nBits = diskindex.nBits;
-                pindexNew->nNonce = diskindex.nNonce;
-                pindexNew->nStatus = diskindex.nStatus;
-                pindexNew->nTx = diskindex.nTx;
-
-                //zerocoin
-                pindexNew->nAccumulatorCheckpoint = diskindex.nAccumulatorCheckpoint;
-                pindexNew->mapZerocoinSupply = diskindex.mapZerocoinSupply;
-                pindexNew->vMintDenominationsInBlock = diskindex.vMintDenominationsInBlock;
-
-                //Proof Of Stake
-                pindexNew->nMint = diskindex.nMint;
-                pindexNew->nMoneySupply = diskindex.nMoneySupply;
-                pindexNew->nFlags = diskindex.nFlags;
-                pindexNew->nStakeModifier = diskindex.nStakeModifier;
-                pindexNew->prevoutStake = diskindex.prevoutStake;
-                pindexNew->nStakeTime = diskindex.nStakeTime;
-                pindexNew->hashProofOfStake = diskindex.hashProofOfStake;
-
-                if (pindexNew->nHeight <= Params().LAST_POW_BLOCK()) {
-                    if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits))
-                        return error("LoadBlockIndex() : CheckProofOfWork failed: %s", pindexNew->ToString());
-                }
-                // ppcoin: build setStakeSeen
-                if (pindexNew->IsProofOfStake())
-                    setStakeSeen.insert(make_pair(pindexNew->prevoutStake, pindexNew->nStakeTime));
+                vDiskIndex.emplace_back();
+                ssValue >> vDiskIndex.back();
+                pcursor->Next();
+            } catch (std::exception& e) {
+                return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+            }
+        }
 
-                //populate accumulator checksum map in memory
-                if(pindexNew->nAccumulatorCheckpoint != 0 && pindexNew->nAccumulatorCheckpoint != nPreviousCheckpoint) {
-                    //Don't load any checkpoints that exist before v2 zNATIVE. The accumulator is invalid for v1 and not used.
-                    if (pindexNew->nHeight >= Params().Zerocoin_Block_V2_Start())
-                        LoadAccumulatorValuesFromDB(pindexNew->nAccumulatorCheckpoint);
+        // Each entry is stored under the hash of its header, the ones above the trusted height are checked now
+        vUntrusted.clear();
+        vHeaders.clear();
+        for (size_t i = 0; i < vDiskIndex.size(); i++) {
+            if (vDiskIndex[i].nHeight > nTrustedHeight) {
+                vUntrusted.emplace_back(i);
+                vHeaders.emplace_back(vDiskIndex[i].GetBlockHeader());
+            }
+        }
+        HashQuarkN(vHeaders, vHashes);
+        for (size_t j = 0; j < vUntrusted.size(); j++) {
+            if (vHashes[j] != vKeyHashes[vUntrusted[j]])
+                return error("%s : block index entry %s does not match its header hash %s", __func__,
+                    vKeyHashes[vUntrusted[j]].ToString(), vHashes[j].ToString());
+        }
 
-                    nPreviousCheckpoint = pindexNew->nAccumulatorCheckpoint;
-                }
+        for (size_t i = 0; i < vDiskIndex.size(); i++) {
+            const CDiskBlockIndex& diskindex = vDiskIndex[i];
+
+            // Construct block index object
+            CBlockIndex* pindexNew = InsertBlockIndex(vKeyHashes[i]);
+            pindexNew->pprev = InsertBlockIndex(diskindex.hashPrev);
+            pindexNew->pnext = InsertBlockIndex(diskindex.hashNext);
+            pindexNew->nHeight = diskindex.nHeight;
+            pindexNew->nFile = diskindex.nFile;
+            pindexNew->nDataPos = diskindex.nDataPos;
+            pindexNew->nUndoPos = diskindex.nUndoPos;
+            pindexNew->nVersion = diskindex.nVersion;
+            pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+            pindexNew->nTime = diskindex.nTime;
+            pindexNew->nBits = diskindex.nBits;
+            pindexNew->nNonce = diskindex.nNonce;
+            pindexNew->nStatus = diskindex.nStatus;
+            pindexNew->nTx = diskindex.nTx;
+
+            //zerocoin
+            pindexNew->nAccumulatorCheckpoint = diskindex.nAccumulatorCheckpoint;
+            pindexNew->mapZerocoinSupply = diskindex.mapZerocoinSupply;
+            pindexNew->vMintDenominationsInBlock = diskindex.vMintDenominationsInBlock;
+
+            //Proof Of Stake
+            pindexNew->nMint = diskindex.nMint;
+            pindexNew->nMoneySupply = diskindex.nMoneySupply;
+            pindexNew->nFlags = diskindex.nFlags;
+            pindexNew->nStakeModifier = diskindex.nStakeModifier;
+            pindexNew->prevoutStake = diskindex.prevoutStake;
+            pindexNew->nStakeTime = diskindex.nStakeTime;
+            pindexNew->hashProofOfStake = diskindex.hashProofOfStake;
+
+            if (pindexNew->nHeight <= Params().LAST_POW_BLOCK()) {
+                if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits))
+                    return error("LoadBlockIndex() : CheckProofOfWork failed: %s", pindexNew->ToString());
+            }
+            // ppcoin: build setStakeSeen
+            if (pindexNew->IsProofOfStake())
+                setStakeSeen.insert(make_pair(pindexNew->prevoutStake, pindexNew->nStakeTime));
 
-                pcursor->Next();
-            } else {
-                break; // if shutdown requested or finished loading block index
+            //populate accumulator checksum map in memory
+            if(pindexNew->nAccumulatorCheckpoint != 0 && pindexNew->nAccumulatorCheckpoint != nPreviousCheckpoint) {
+                //Don't load any checkpoints that exist before v2 zNATIVE. The accumulator is invalid for v1 and not used.
+                if (pindexNew->nHeight >= Params().Zerocoin_Block_V2_Start())
+                    LoadAccumulatorValuesFromDB(pindexNew->nAccumulatorCheckpoint);
+
+                nPreviousCheckpoint = pindexNew->nAccumulatorCheckpoint;
             }
-        } catch (std::exception& e) {
-            return error("%s : Deserialize or I/O error - %s", __func__, e.what());
         }
     }
 
     return true;
 }
 
-CZerocoinDB::CZerocoinDB(size_t nCacheSize, bool fMemory, bool fWipe) : CLevelDBWrapper(GetDataDir() / "zerocoin", nCacheSize, fMemory, fWipe)
+CZerocoinDB::CZerocoinDB(size_t nCacheSize, bool fMemory, bool fWipe) : CLevelDBWrapper(GetDataDir() / "zerocoin", nCacheSize, fMemory, fWipe), fSerialFilterLoaded(false)
+{
+}
+
+bool CZerocoinDB::LoadSerialFilter()
 {
+    LOCK(cs_serialFilter);
+    return LoadSerialFilterInternal(DEFAULT_SERIAL_FILTER_CAPACITY);
+}
+
+bool CZerocoinDB::LoadSerialFilterInternal(size_t nCapacity)
+{
+    AssertLockHeld(cs_serialFilter);
+    fSerialFilterLoaded = false;
+
+    boost::scoped_ptr<leveldb::Iterator> pcursor(NewIterator());
+    CDataStream ssKeySet(SER_DISK, CLIENT_VERSION);
+    ssKeySet << make_pair('s', uint256(0));
+    pcursor->Seek(ssKeySet.str());
+
+    std::vector<uint256> vSerials;
+    while (pcursor->Valid()) {
+        try {
+            leveldb::Slice slKey = pcursor->key();
+            CDataStream ssKey(slKey.data(), slKey.data() + slKey.size(), SER_DISK, CLIENT_VERSION);
+            char chType;
+            ssKey >> chType;
+            if (chType != 's')
+                break;
+            uint256 hashSerial;
+            ssKey >> hashSerial;
+            vSerials.emplace_back(hashSerial);
+            pcursor->Next();
+        } catch (std::exception& e) {
+            return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+        }
+    }
+
+    // Leave room to grow, so the filter is not rebuilt again soon
+    serialFilter.reset(std::max(nCapacity, vSerials.size() * 2));
+    for (const uint256& hashSerial : vSerials)
+        serialFilter.insert(hashSerial);
+    fSerialFilterLoaded = true;
+
+    LogPrintf("%s: loaded %u spent serials, filter capacity %u\n", __func__, vSerials.size(), serialFilter.capacity());
+    return true;
 }
 
 bool CZerocoinDB::WriteCoinMintBatch(const std::vector<std::pair<libzerocoin::PublicCoin, uint256> >& mintInfo)
@@ -327,6 +406,8 @@ bool CZerocoinDB::EraseCoinMint(const CBigNum& bnPubcoin)
 
 bool CZerocoinDB::WriteCoinSpendBatch(const std::vector<std::pair<libzerocoin::CoinSpend, uint256> >& spendInfo)
 {
+    // The filter gets the serials before the database, it may hold serials that are not spent but never misses one that is
+    LOCK(cs_serialFilter);
     CLevelDBBatch batch;
     size_t count = 0;
     for (std::vector<std::pair<libzerocoin::CoinSpend, uint256> >::const_iterator it=spendInfo.begin(); it != spendInfo.end(); it++) {
@@ -335,11 +416,18 @@ bool CZerocoinDB::WriteCoinSpendBatch(const std::vector<std::pair<libzerocoin::C
         ss << bnSerial;
         uint256 hash = Hash(ss.begin(), ss.end());
         batch.Write(make_pair('s', hash), it->second);
+        if (fSerialFilterLoaded)
+            serialFilter.insert(hash);
         ++count;
     }
 
     LogPrint("zero", "Writing %u coin spends to db.\n", (unsigned int)count);
-    return WriteBatch(batch, true);
+    if (!WriteBatch(batch, true))
+        return false;
+
+    if (fSerialFilterLoaded && serialFilter.IsFull())
+        LoadSerialFilterInternal(serialFilter.capacity() * 2);
+    return true;
 }
 
 bool CZerocoinDB::ReadCoinSpend(const CBigNum& bnSerial, uint256& txHash)
@@ -348,14 +436,21 @@ bool CZerocoinDB::ReadCoinSpend(const CBigNum& bnSerial, uint256& txHash)
     ss << bnSerial;
     uint256 hash = Hash(ss.begin(), ss.end());
 
-    return Read(make_pair('s', hash), txHash);
+    return ReadCoinSpend(hash, txHash);
 }
 
 bool CZerocoinDB::ReadCoinSpend(const uint256& hashSerial, uint256 &txHash)
 {
+    {
+        LOCK(cs_serialFilter);
+        if (fSerialFilterLoaded && !serialFilter.contains(hashSerial))
+            return false;
+    }
+
     return Read(make_pair('s', hashSerial), txHash);
 }
 
+// The serial stays in the filter, where it only costs a database read
 bool CZerocoinDB::EraseCoinSpend(const CBigNum& bnSerial)
 {
     CDataStream ss(SER_GETHASH, 0);
@@ -408,6 +503,27 @@ bool CZerocoinDB::WipeCoins(std::string strType)
     return true;
 }
 
+bool CZerocoinDB::WriteReindexProgress(int nHeight, const uint256& hashBlock)
+{
+    return Write('R', make_pair(nHeight, hashBlock), true);
+}
+
+bool CZerocoinDB::ReadReindexProgress(int& nHeight, uint256& hashBlock)
+{
+    std::pair<int, uint256> progress;
+    if (!Read('R', progress))
+        return false;
+
+    nHeight = progress.first;
+    hashBlock = progress.second;
+    return true;
+}
+
+bool CZerocoinDB::EraseReindexProgress()
+{
+    return Erase('R', true);
+}
+
 bool CZerocoinDB::WriteAccumulatorValue(const uint32_t& nChecksum, const CBigNum& bnValue)
 {
     LogPrint("zero","%s : checksum:%d val:%s\n", __func__, nChecksum, bnValue.GetHex());
@@ -424,3 +540,33 @@ bool CZerocoinDB::EraseAccumulatorValue(const uint32_t& nChecksum)
     LogPrint("zero", "%s : checksum:%d\n", __func__, nChecksum);
     return Erase(make_pair('2', nChecksum));
 }
+
+bool CZerocoinDB::WriteBlockPubcoins(const uint256& hashBlock, const std::vector<CBlockPubcoin>& vPubcoins)
+{
+    return Write(make_pair('b', hashBlock), vPubcoins);
+}
+
+bool CZerocoinDB::ReadBlockPubcoins(const uint256& hashBlock, std::vector<CBlockPubcoin>& vPubcoins)
+{
+    return Read(make_pair('b', hashBlock), vPubcoins);
+}
+
+bool CZerocoinDB::EraseBlockPubcoins(const uint256& hashBlock)
+{
+    return Erase(make_pair('b', hashBlock));
+}
+
+bool CZerocoinDB::WriteBlockSerials(const uint256& hashBlock, const std::vector<CBlockSerial>& vSerials)
+{
+    return Write(make_pair('S', hashBlock), vSerials);
+}
+
+bool CZerocoinDB::ReadBlockSerials(const uint256& hashBlock, std::vector<CBlockSerial>& vSerials)
+{
+    return Read(make_pair('S', hashBlock), vSerials);
+}
+
+bool CZerocoinDB::EraseBlockSerials(const uint256& hashBlock)
+{
+    return Erase(make_pair('S', hashBlock));
+}
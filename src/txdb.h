@@ -9,6 +9,7 @@
 
 #include "leveldbwrapper.h"
 #include "main.h"
+#include "zNATIVE/serialfilter.h"
 #include "zNATIVE/zerocoin.h"
 
 #include <map>
@@ -25,6 +26,8 @@ static const int64_t nDefaultDbCache = 100;
 static const int64_t nMaxDbCache = sizeof(void*) > 4 ? 4096 : 1024;
 //! min. -dbcache in (MiB)
 static const int64_t nMinDbCache = 4;
+//! Block index entries read from disk before their hashes are computed together
+static const size_t BLOCK_INDEX_LOAD_BATCH_SIZE = 10000;
 
 /** CCoinsView backed by the LevelDB coin database (chainstate/) */
 class CCoinsViewDB : public CCoinsView
@@ -66,7 +69,8 @@ public:
     bool ReadFlag(const std::string& name, bool& fValue);
     bool WriteInt(const std::string& name, int nValue);
     bool ReadInt(const std::string& name, int& nValue);
-    bool LoadBlockIndexGuts();
+    /** Load mapBlockIndex, the entries up to nTrustedHeight keep their stored hash without hashing their header */
+    bool LoadBlockIndexGuts(int nTrustedHeight = -1);
 };
 
 /** Zerocoin database (zerocoin/) */
@@ -79,7 +83,16 @@ private:
     CZerocoinDB(const CZerocoinDB&);
     void operator=(const CZerocoinDB&);
 
+protected:
+    /** Spent serials, a serial that misses the filter is not looked up on disk */
+    CCriticalSection cs_serialFilter;
+    CSerialFilter serialFilter;
+    bool fSerialFilterLoaded;
+    bool LoadSerialFilterInternal(size_t nCapacity);
+
 public:
+    /** Load the filter of the spent serials, until then every serial lookup reads the database */
+    bool LoadSerialFilter();
     /** Write zNATIVE mints to the zerocoinDB in a batch */
     bool WriteCoinMintBatch(const std::vector<std::pair<libzerocoin::PublicCoin, uint256> >& mintInfo);
     bool ReadCoinMint(const CBigNum& bnPubcoin, uint256& txHash);
@@ -91,9 +104,21 @@ public:
     bool EraseCoinMint(const CBigNum& bnPubcoin);
     bool EraseCoinSpend(const CBigNum& bnSerial);
     bool WipeCoins(std::string strType);
+    /** Last block flushed by ReindexZerocoinDB(), kept until the reindex is complete so it can be resumed */
+    bool WriteReindexProgress(int nHeight, const uint256& hashBlock);
+    bool ReadReindexProgress(int& nHeight, uint256& hashBlock);
+    bool EraseReindexProgress();
     bool WriteAccumulatorValue(const uint32_t& nChecksum, const CBigNum& bnValue);
     bool ReadAccumulatorValue(const uint32_t& nChecksum, CBigNum& bnValue);
     bool EraseAccumulatorValue(const uint32_t& nChecksum);
+    /** Index of the pubcoins minted in each block, so the accumulators do not have to read whole blocks */
+    bool WriteBlockPubcoins(const uint256& hashBlock, const std::vector<CBlockPubcoin>& vPubcoins);
+    bool ReadBlockPubcoins(const uint256& hashBlock, std::vector<CBlockPubcoin>& vPubcoins);
+    bool EraseBlockPubcoins(const uint256& hashBlock);
+    /** Index of the serials spent in each block, so RPC can list them without reading whole blocks */
+    bool WriteBlockSerials(const uint256& hashBlock, const std::vector<CBlockSerial>& vSerials);
+    bool ReadBlockSerials(const uint256& hashBlock, std::vector<CBlockSerial>& vSerials);
+    bool EraseBlockSerials(const uint256& hashBlock);
 };
 
 #endif // BITCOIN_TXDB_H
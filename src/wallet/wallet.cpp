@@ -1659,14 +1659,10 @@ CAmount CWallet::GetBalance() const
     return nTotal;
 }
 
-std::map<libzerocoin::CoinDenomination, int> mapMintMaturity;
-int nLastMaturityCheck = 0;
 CAmount CWallet::GetZerocoinBalance(bool fMatureOnly) const
 {
     if (fMatureOnly) {
-        if (chainActive.Height() > nLastMaturityCheck)
-            mapMintMaturity = GetMintMaturityHeight();
-        nLastMaturityCheck = chainActive.Height();
+        std::map<libzerocoin::CoinDenomination, int> mapMintMaturity = GetMintMaturityHeight();
 
         CAmount nBalance = 0;
         vector<CMintMeta> vMints = zNATIVETracker->GetMints(true);
@@ -4737,10 +4733,8 @@ bool CWallet::MintsToInputVector(std::map<CBigNum, CZerocoinMint>& mapMintsSelec
             CMintMeta meta = zNATIVETracker->Get(GetSerialHash(mint.GetSerialNumber()));
             CoinWitnessData *coinWitness = zNATIVETracker->GetSpendCache(meta.hashStake);
 
-            if (!coinWitness->nHeightAccEnd) {
-                *coinWitness = CoinWitnessData(mint);
-                coinWitness->SetHeightMintAdded(mint.GetHeight());
-            }
+            if (!coinWitness->nHeightAccEnd)
+                LoadSpendWitness(mint, meta.hashStake, coinWitness);
 
             // Generate the witness for each mint being spent
             if (!GenerateAccumulatorWitness(coinWitness, mapAccumulators, pindexCheckpoint)) {
@@ -5487,6 +5481,20 @@ void ThreadPrecomputeSpends()
     LogPrintf("ThreadPrecomputeSpends exiting,\n");
 }
 
+void CWallet::LoadSpendWitness(CZerocoinMint& mint, const uint256& hashStake, CoinWitnessData* coinWitness)
+{
+    // Continue from the witness the precomputer persisted, so only the blocks since then are replayed
+    CoinWitnessCacheData witnessCache;
+    if (GetBoolArg("-precompute", true) && CWalletDB("precomputes.dat", "cr+").ReadPrecompute(hashStake, witnessCache) &&
+            witnessCache.nHeightAccEnd && witnessCache.coinAmount == mint.GetValue()) {
+        *coinWitness = CoinWitnessData(witnessCache);
+        LogPrint("precompute", "%s: Got Witness Data from precompute database: %s\n", __func__, coinWitness->ToString());
+    } else {
+        *coinWitness = CoinWitnessData(mint);
+        coinWitness->SetHeightMintAdded(mint.GetHeight());
+    }
+}
+
 void CWallet::PrecomputeSpends()
 {
     LogPrintf("Precomputer started\n");
@@ -5675,7 +5683,9 @@ void CWallet::PrecomputeSpends()
                 }
 
 
+                // Persist the advanced witness right away so spends and restarts can continue from it
                 CoinWitnessCacheData serialData(witnessData);
+                walletdb.WritePrecompute(serialHash, serialData);
 
                 // If the LRU cache already has a entry for it, update the entry and move it to the front of the list
                 auto it = item_map.find(serialHash);
@@ -5760,6 +5770,13 @@ void CWallet::PrecomputeSpends()
             break;
 
         LogPrint("precompute", "%s: Finished precompute round...\n\n", __func__);
-        MilliSleep(5000);
+
+        // Wait for the next block before advancing the witnesses again
+        {
+            WaitableLock lock(csBestBlock);
+            cvBlockChange.wait_for(lock, std::chrono::seconds(5));
+        }
+        // The condition wait is not an interruption point
+        boost::this_thread::interruption_point();
     }
 }
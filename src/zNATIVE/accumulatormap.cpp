@@ -73,6 +73,26 @@ bool AccumulatorMap::Accumulate(const PublicCoin& pubCoin, bool fSkipValidation)
     return true;
 }
 
+//Add a list of zerocoins, raising the accumulator of each denomination once.
+bool AccumulatorMap::Accumulate(const list<PublicCoin>& listPubCoins, bool fSkipValidation)
+{
+    map<CoinDenomination, vector<CBigNum> > mapValues;
+    for (const PublicCoin& pubCoin : listPubCoins) {
+        CoinDenomination denom = pubCoin.getDenomination();
+        if (denom == CoinDenomination::ZQ_ERROR)
+            return false;
+
+        if (!fSkipValidation && !pubCoin.validate())
+            throw std::runtime_error("Coin is not valid");
+
+        mapValues[denom].emplace_back(pubCoin.getValue());
+    }
+
+    for (auto& it : mapValues)
+        mapAccumulators.at(it.first)->incrementBatch(it.second);
+    return true;
+}
+
 libzerocoin::Accumulator AccumulatorMap::GetAccumulator(libzerocoin::CoinDenomination denom)
 {
     return libzerocoin::Accumulator(params, denom, GetValue(denom));
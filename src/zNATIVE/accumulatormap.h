@@ -20,6 +20,7 @@ public:
     bool Load(uint256 nCheckpoint);
     void Load(const AccumulatorCheckpoints::Checkpoint& checkpoint);
     bool Accumulate(const libzerocoin::PublicCoin& pubCoin, bool fSkipValidation = false);
+    bool Accumulate(const std::list<libzerocoin::PublicCoin>& listPubCoins, bool fSkipValidation = false);
     libzerocoin::Accumulator GetAccumulator(libzerocoin::CoinDenomination denom);
     CBigNum GetValue(libzerocoin::CoinDenomination denom);
     uint256 GetCheckpoint();
@@ -241,31 +241,71 @@ bool InitializeAccumulators(const int nHeight, int& nHeightCheckpoint, Accumulat
 }
 
 
-//Get checkpoint value for a specific block height
-bool CalculateAccumulatorCheckpoint(int nHeight, uint256& nCheckpoint, AccumulatorMap& mapAccumulators)
+//How many blocks back the accumulator values of a checkpoint are kept in memory
+static const int ROLLING_ACCUMULATORS_DEPTH = 100;
+
+//Accumulator values of recent checkpoints, keyed by the hash of the block before the checkpoint block.
+//A checkpoint only depends on the chain up to its parent, so values from a disconnected branch are never used again.
+static std::map<uint256, std::pair<int, AccumulatorCheckpoints::Checkpoint> > mapRollingAccumulators;
+static CCriticalSection cs_rollingAccumulators;
+
+//Continue from the values of the previous checkpoint when they are still in memory
+static bool LoadRollingAccumulators(const int nHeight, AccumulatorMap& mapAccumulators)
 {
-    if (nHeight < Params().Zerocoin_Block_V2_Start()) {
-        nCheckpoint = 0;
-        return true;
+    //the forced recalculation and the hard checkpoints do not start from the previous checkpoint
+    if (Params().NetworkID() != CBaseChainParams::REGTEST &&
+        (nHeight == Params().Zerocoin_Block_RecalculateAccumulators() || nHeight <= Params().Zerocoin_Block_V2_Start() + 20))
+        return false;
+
+    uint256 nCheckpointPrev = chainActive[nHeight - 1]->nAccumulatorCheckpoint;
+    if (nCheckpointPrev == 0)
+        return false;
+
+    AccumulatorCheckpoints::Checkpoint checkpoint;
+    {
+        LOCK(cs_rollingAccumulators);
+        auto it = mapRollingAccumulators.find(chainActive[nHeight - 11]->GetBlockHash());
+        if (it == mapRollingAccumulators.end())
+            return false;
+        checkpoint = it->second.second;
     }
 
-    //the checkpoint is updated every ten blocks, return current active checkpoint if not update block
-    if (nHeight % 10 != 0) {
-        nCheckpoint = chainActive[nHeight - 1]->nAccumulatorCheckpoint;
-        return true;
+    //only use values that match the checkpoint the chain recorded
+    for (auto denom : zerocoinDenomList) {
+        auto it = checkpoint.find(denom);
+        if (it == checkpoint.end() || GetChecksum(it->second) != ParseChecksum(nCheckpointPrev, denom))
+            return false;
     }
 
-    //set the accumulators to last checkpoint value
-    int nHeightCheckpoint;
-    mapAccumulators.Reset();
-    if (!InitializeAccumulators(nHeight, nHeightCheckpoint, mapAccumulators))
-        return error("%s: failed to initialize accumulators", __func__);
+    mapAccumulators.Reset(Params().Zerocoin_Params(false));
+    mapAccumulators.Load(checkpoint);
+    return true;
+}
 
+static void SaveRollingAccumulators(const int nHeight, AccumulatorMap& mapAccumulators)
+{
+    AccumulatorCheckpoints::Checkpoint checkpoint;
+    for (auto denom : zerocoinDenomList)
+        checkpoint[denom] = mapAccumulators.GetValue(denom);
+
+    LOCK(cs_rollingAccumulators);
+    mapRollingAccumulators[chainActive[nHeight - 1]->GetBlockHash()] = make_pair(nHeight, checkpoint);
+
+    for (auto it = mapRollingAccumulators.begin(); it != mapRollingAccumulators.end();) {
+        if (it->second.first <= nHeight - ROLLING_ACCUMULATORS_DEPTH)
+            it = mapRollingAccumulators.erase(it);
+        else
+            ++it;
+    }
+}
+
+//Accumulate all coins over the ten blocks before the checkpoint that havent been accumulated (height - 20 through height - 11)
+static bool AccumulateCheckpointRange(const int nHeightCheckpoint, const int nHeight, AccumulatorMap& mapAccumulators, int& nTotalMintsFound)
+{
     //Whether this should filter out invalid/fraudulent outpoints
     bool fFilterInvalid = nHeight >= Params().Zerocoin_Block_RecalculateAccumulators();
 
-    //Accumulate all coins over the last ten blocks that havent been accumulated (height - 20 through height - 11)
-    int nTotalMintsFound = 0;
+    std::list<PublicCoin> listPubcoinsRange;
     CBlockIndex *pindex = chainActive[nHeightCheckpoint - 20];
 
     while (pindex->nHeight < nHeight - 10) {
@@ -280,25 +320,73 @@ bool CalculateAccumulatorCheckpoint(int nHeight, uint256& nCheckpoint, Accumulat
         }
 
         //grab mints from this block
-        CBlock block;
-        if(!ReadBlockFromDisk(block, pindex))
-            return error("%s: failed to read block from disk", __func__);
-
         std::list<PublicCoin> listPubcoins;
-        if (!BlockToPubcoinList(block, listPubcoins, fFilterInvalid))
+        if (!GetBlockPubcoinList(pindex, listPubcoins, fFilterInvalid))
             return error("%s: failed to get zerocoin mintlist from block %d", __func__, pindex->nHeight);
 
         nTotalMintsFound += listPubcoins.size();
         LogPrint("zero", "%s found %d mints\n", __func__, listPubcoins.size());
 
-        //add the pubcoins to accumulator
-        for (const PublicCoin& pubcoin : listPubcoins) {
-            if(!mapAccumulators.Accumulate(pubcoin, true))
-                return error("%s: failed to add pubcoin to accumulator at height %d", __func__, pindex->nHeight);
-        }
+        listPubcoinsRange.splice(listPubcoinsRange.end(), listPubcoins);
         pindex = chainActive.Next(pindex);
     }
 
+    //add the pubcoins to the accumulators, one exponentiation per denomination for the whole range
+    if (!mapAccumulators.Accumulate(listPubcoinsRange, true))
+        return error("%s: failed to add pubcoins to accumulator for block %d", __func__, nHeight);
+
+    return true;
+}
+
+//Get checkpoint value for a specific block height
+bool CalculateAccumulatorCheckpoint(int nHeight, uint256& nCheckpoint, AccumulatorMap& mapAccumulators)
+{
+    if (nHeight < Params().Zerocoin_Block_V2_Start()) {
+        nCheckpoint = 0;
+        return true;
+    }
+
+    //the checkpoint is updated every ten blocks, return current active checkpoint if not update block
+    if (nHeight % 10 != 0) {
+        nCheckpoint = chainActive[nHeight - 1]->nAccumulatorCheckpoint;
+        return true;
+    }
+
+    //set the accumulators to last checkpoint value, from memory if it was calculated recently
+    int nHeightCheckpoint = nHeight;
+    bool fRolling = LoadRollingAccumulators(nHeight, mapAccumulators);
+    if (!fRolling) {
+        mapAccumulators.Reset();
+        if (!InitializeAccumulators(nHeight, nHeightCheckpoint, mapAccumulators))
+            return error("%s: failed to initialize accumulators", __func__);
+    }
+
+    int nTotalMintsFound = 0;
+    if (!AccumulateCheckpointRange(nHeightCheckpoint, nHeight, mapAccumulators, nTotalMintsFound))
+        return false;
+
+    //compare against a full recalculation from the database
+    if (fRolling && GetBoolArg("-checkaccumulators", false)) {
+        AccumulatorMap mapRecalculated(Params().Zerocoin_Params(false));
+        int nHeightRecalculated = nHeight;
+        int nMintsRecalculated = 0;
+        if (!InitializeAccumulators(nHeight, nHeightRecalculated, mapRecalculated) ||
+            !AccumulateCheckpointRange(nHeightRecalculated, nHeight, mapRecalculated, nMintsRecalculated))
+            return error("%s: failed to recalculate accumulators for block %d", __func__, nHeight);
+
+        for (auto denom : zerocoinDenomList) {
+            if (mapRecalculated.GetValue(denom) != mapAccumulators.GetValue(denom)) {
+                LogPrintf("%s: rolling accumulator for denomination %d does not match recalculated value at block %d\n",
+                          __func__, ZerocoinDenominationToInt(denom), nHeight);
+                mapAccumulators = std::move(mapRecalculated);
+                nTotalMintsFound = nMintsRecalculated;
+                break;
+            }
+        }
+    }
+
+    SaveRollingAccumulators(nHeight, mapAccumulators);
+
     // if there were no new mints found, the accumulator checkpoint will be the same as the last checkpoint
     if (nTotalMintsFound == 0)
         nCheckpoint = chainActive[nHeight - 1]->nAccumulatorCheckpoint;
@@ -361,47 +449,49 @@ int ComputeAccumulatedCoins(int nHeightEnd, libzerocoin::CoinDenomination denom)
 
 list<PublicCoin> GetPubcoinFromBlock(const CBlockIndex* pindex){
     //grab mints from this block
-    CBlock block;
-    if(!ReadBlockFromDisk(block, pindex))
-        throw GetPubcoinException("GetPubcoinFromBlock: failed to read block from disk while adding pubcoins to witness");
     list<libzerocoin::PublicCoin> listPubcoins;
-    if(!BlockToPubcoinList(block, listPubcoins, true))
+    if(!GetBlockPubcoinList(pindex, listPubcoins, true))
         throw GetPubcoinException("GetPubcoinFromBlock: failed to get zerocoin mintlist from block "+std::to_string(pindex->nHeight)+"\n");
     return listPubcoins;
 }
 
 
 
-int AddBlockMintsToAccumulator(const CoinDenomination den, const CBloomFilter filter, const CBlockIndex* pindex,
-                               libzerocoin::Accumulator* accumulator, bool isWitness, list<CBigNum>& notAddedCoins)
+int AddBlockMintsToAccumulator(const CoinDenomination den, const CBlockIndex* pindex,
+                               std::vector<Accumulator>& vWitnessAccumulators, std::vector<LightWitnessRequest>& vRequests)
 {
-    // if this block contains mints of the denomination that is being spent, then add them to the witness
-    int nMintsAdded = 0;
-    if (pindex->MintedDenomination(den)) {
-        //add the mints to the witness
-        for (const PublicCoin& pubcoin : GetPubcoinFromBlock(pindex)) {
-            if (pubcoin.getDenomination() != den) {
-                continue;
-            }
+    // if this block contains mints of the denomination that is being spent, then add them to each witness
+    if (!pindex->MintedDenomination(den))
+        return 0;
 
-            if (isWitness && filter.contains(pubcoin.getValue().getvch())) {
-                notAddedCoins.emplace_back(pubcoin.getValue());
+    std::vector<CBigNum> vBlockValues;
+    for (const PublicCoin& pubcoin : GetPubcoinFromBlock(pindex)) {
+        if (pubcoin.getDenomination() == den)
+            vBlockValues.emplace_back(pubcoin.getValue());
+    }
+
+    //coins matching a request's filter are handed back to it instead of being added to its witness
+    for (unsigned int i = 0; i < vRequests.size(); i++) {
+        std::vector<CBigNum> vValues;
+        for (const CBigNum& bnValue : vBlockValues) {
+            if (vRequests[i].filter.contains(bnValue.getvch())) {
+                vRequests[i].listFilteredCoins.emplace_back(bnValue);
                 continue;
             }
-
-            accumulator->increment(pubcoin.getValue());
-            ++nMintsAdded;
+            vValues.emplace_back(bnValue);
         }
+        vWitnessAccumulators[i].incrementBatch(vValues);
+        vRequests[i].nMintsAdded += vValues.size();
     }
 
-    return nMintsAdded;
+    return vBlockValues.size();
 }
 
 int AddBlockMintsToAccumulator(const libzerocoin::PublicCoin& coin, const int nHeightMintAdded, const CBlockIndex* pindex,
                                libzerocoin::Accumulator* accumulator, bool isWitness)
 {
     // if this block contains mints of the denomination that is being spent, then add them to the witness
-    int nMintsAdded = 0;
+    std::vector<CBigNum> vValues;
     if (pindex->MintedDenomination(coin.getDenomination())) {
         //add the mints to the witness
         for (const PublicCoin& pubcoin : GetPubcoinFromBlock(pindex)) {
@@ -411,12 +501,12 @@ int AddBlockMintsToAccumulator(const libzerocoin::PublicCoin& coin, const int nH
             if (isWitness && pindex->nHeight == nHeightMintAdded && pubcoin.getValue() == coin.getValue())
                 continue;
 
-            accumulator->increment(pubcoin.getValue());
-            ++nMintsAdded;
+            vValues.emplace_back(pubcoin.getValue());
         }
+        accumulator->incrementBatch(vValues);
     }
 
-    return nMintsAdded;
+    return vValues.size();
 }
 
 
@@ -608,13 +698,11 @@ bool calculateAccumulatedBlocksFor(
         CBigNum &bnAccValue,
         libzerocoin::Accumulator &accumulator,
         libzerocoin::CoinDenomination den,
-        CBloomFilter filter,
-        libzerocoin::Accumulator &witnessAccumulator,
-        list<CBigNum>& ret,
+        std::vector<libzerocoin::Accumulator> &vWitnessAccumulators,
+        std::vector<LightWitnessRequest> &vRequests,
         string& strError
 ){
     bool fDoubleCounted = false;
-    int nMintsAdded = 0;
     while (pindex) {
 
         if (pindex->nHeight >= nHeightStop) {
@@ -625,14 +713,15 @@ bool calculateAccumulatedBlocksFor(
             bnAccValue = 0;
             uint256 nCheckpointSpend = chainActive[pindex->nHeight + 10]->nAccumulatorCheckpoint;
             if (!GetAccumulatorValueFromDB(nCheckpointSpend, den, bnAccValue) || bnAccValue == 0) {
-                throw new ChecksumInDbNotFoundException(
+                throw ChecksumInDbNotFoundException(
                         "calculateAccumulatedBlocksFor : failed to find checksum in database for accumulator");
             }
             accumulator.setValue(bnAccValue);
             break;
         }
 
-        nMintsAdded += AddBlockMintsToAccumulator(den, filter, pindex, &witnessAccumulator, true, ret);
+        boost::this_thread::interruption_point();
+        AddBlockMintsToAccumulator(den, pindex, vWitnessAccumulators, vRequests);
 
         // 10 blocks were accumulated twice when zNATIVE v2 was activated
         if (pindex->nHeight == 1050010 && !fDoubleCounted) {
@@ -644,15 +733,6 @@ bool calculateAccumulatedBlocksFor(
         pindex = chainActive.Next(pindex);
     }
 
-    // A certain amount of accumulated coins are required
-    if (nMintsAdded < Params().Zerocoin_RequiredAccumulation()) {
-        strError = _(strprintf("Less than %d mints added, unable to create spend",
-                               Params().Zerocoin_RequiredAccumulation()).c_str());
-        throw NotEnoughMintsException(strError);
-    }
-
-    LogPrintf("calculateAccumulatedBlocksFor() : nMintsAdded %d",nMintsAdded);
-
     return true;
 }
 
@@ -721,23 +801,16 @@ bool CalculateAccumulatorWitnessFor(
         int startHeight,
         int maxCalulationRange,
         CoinDenomination den,
-        const CBloomFilter& filter,
+        std::vector<LightWitnessRequest>& vRequests,
         Accumulator& accumulator,
-        AccumulatorWitness& witness,
         int& nMintsAdded,
         string& strError,
-        list<CBigNum>& ret,
         int &heightStop
 ){
     // Lock
     if (!LockMethod()) return false;
 
     try {
-        // Dummy coin init
-        PublicCoin temp(params, 0, den);
-        // Dummy Acc init
-        Accumulator testingAcc(params, den);
-
         //get the checkpoint added at the next multiple of 10
         int nHeightCheckpoint = startHeight + (10 - (startHeight % 10));
 
@@ -746,7 +819,8 @@ bool CalculateAccumulatorWitnessFor(
         CBigNum bnAccValue = 0;
         if (GetAccumulatorValue(nHeightCheckpoint, den, bnAccValue)) {
             accumulator.setValue(bnAccValue);
-            witness.resetValue(accumulator, temp);
+            for (LightWitnessRequest& request : vRequests)
+                request.bnWitnessValue = accumulator.getValue();
         }
 
         // Add the pubcoins from the blockchain up to the next checksum starting from the block
@@ -764,8 +838,13 @@ bool CalculateAccumulatorWitnessFor(
 
         nMintsAdded = 0;
 
-        // Starts on top of the witness that the node sent
-        libzerocoin::Accumulator witnessAccumulator(params, den, witness.getValue());
+        // Each request starts on top of the witness that its node sent
+        std::vector<Accumulator> vWitnessAccumulators;
+        for (LightWitnessRequest& request : vRequests) {
+            request.nMintsAdded = 0;
+            request.listFilteredCoins.clear();
+            vWitnessAccumulators.emplace_back(params, den, request.bnWitnessValue);
+        }
 
         if(!calculateAccumulatedBlocksFor(
                 startHeight,
@@ -774,19 +853,22 @@ bool CalculateAccumulatorWitnessFor(
                 bnAccValue,
                 accumulator,
                 den,
-                filter,
-                witnessAccumulator,
-                ret,
+                vWitnessAccumulators,
+                vRequests,
                 strError
         ))
             return error("CalculateAccumulatorWitnessFor(): Calculate accumulated coins failed");
 
-        // reset the value
-        witness.resetValue(witnessAccumulator, temp);
+        // reset the values, the accumulator is shared once its value came from the chain
+        for (unsigned int i = 0; i < vRequests.size(); i++) {
+            vRequests[i].bnWitnessValue = vWitnessAccumulators[i].getValue();
+            if (bnAccValue != 0)
+                vRequests[i].bnAccumulatorValue = accumulator.getValue();
+        }
 
         // calculate how many mints of this denomination existed in the accumulator we initialized
         nMintsAdded += ComputeAccumulatedCoins(startHeight, den);
-        LogPrint("zero", "%s : %d mints added to witness\n", __func__, nMintsAdded);
+        LogPrint("zero", "%s : %d mints added to witness for %d requests\n", __func__, nMintsAdded, vRequests.size());
 
         return true;
 
@@ -888,44 +970,88 @@ bool GenerateAccumulatorWitness(
 
 
 
-map<CoinDenomination, int> GetMintMaturityHeight()
+/**
+ * Running count of the mints of each denomination on the active chain, so the maturity heights
+ * can be found without walking the chain. Entry i is for height Zerocoin_StartHeight() + i and
+ * counts the mints of the blocks after the start height up to and including that height.
+ */
+static CCriticalSection cs_mintCounts;
+static std::vector<const CBlockIndex*> vMintCountBlocks;
+static std::map<CoinDenomination, std::vector<int> > mapMintCounts;
+static const CBlockIndex* pindexMaturity = nullptr;
+static map<CoinDenomination, int> mapMaturityHeight;
+
+//! Bring the mint counts in line with the active chain up to nHeight, dropping the blocks of a reorg
+static void SyncMintCounts(int nHeight)
 {
-    map<CoinDenomination, pair<int, int > > mapDenomMaturity;
-    for (auto denom : libzerocoin::zerocoinDenomList)
-        mapDenomMaturity.insert(make_pair(denom, make_pair(0, 0)));
+    const int nStartHeight = Params().Zerocoin_StartHeight();
 
-    int nConfirmedHeight = chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations();
-
-    // A mint need to get to at least the min maturity height before it will spend.
-    int nMinimumMaturityHeight = nConfirmedHeight - (nConfirmedHeight % 10);
-    CBlockIndex* pindex = chainActive[nConfirmedHeight];
+    while (!vMintCountBlocks.empty()) {
+        int nHeightLast = nStartHeight + (int)vMintCountBlocks.size() - 1;
+        if (nHeightLast <= chainActive.Height() && chainActive[nHeightLast] == vMintCountBlocks.back())
+            break;
+        vMintCountBlocks.pop_back();
+        for (auto& denomCounts : mapMintCounts)
+            denomCounts.second.pop_back();
+    }
 
-    while (pindex && pindex->nHeight > Params().Zerocoin_StartHeight()) {
-        bool isFinished = true;
+    for (int nHeightNext = nStartHeight + (int)vMintCountBlocks.size(); nHeightNext <= nHeight; nHeightNext++) {
+        const CBlockIndex* pindex = chainActive[nHeightNext];
+        vMintCountBlocks.emplace_back(pindex);
         for (auto denom : libzerocoin::zerocoinDenomList) {
-            //If the denom has not already had a mint added to it, then see if it has a mint added on this block
-            if (mapDenomMaturity.at(denom).first < Params().Zerocoin_RequiredAccumulation()) {
-                mapDenomMaturity.at(denom).first += count(pindex->vMintDenominationsInBlock.begin(),
-                                                          pindex->vMintDenominationsInBlock.end(), denom);
+            std::vector<int>& vCounts = mapMintCounts[denom];
+            //the walk this replaces never looked at the mints of the start block itself
+            int nMints = nHeightNext == nStartHeight ? 0 : count(pindex->vMintDenominationsInBlock.begin(), pindex->vMintDenominationsInBlock.end(), denom);
+            vCounts.emplace_back((vCounts.empty() ? 0 : vCounts.back()) + nMints);
+        }
+    }
+}
 
-                //if mint was found then record this block as the first block that maturity occurs.
-                if (mapDenomMaturity.at(denom).first >= Params().Zerocoin_RequiredAccumulation())
-                    mapDenomMaturity.at(denom).second = std::min(pindex->nHeight, nMinimumMaturityHeight);
+void ResetMintMaturityCache()
+{
+    LOCK(cs_mintCounts);
+    vMintCountBlocks.clear();
+    mapMintCounts.clear();
+    pindexMaturity = nullptr;
+    mapMaturityHeight.clear();
+}
 
-                //Signal that we are finished
-                isFinished = false;
-            }
-        }
+map<CoinDenomination, int> GetMintMaturityHeight()
+{
+    LOCK(cs_mintCounts);
 
-        if (isFinished)
-            break;
-        pindex = chainActive[pindex->nHeight - 1];
-    }
+    //the maturity heights only change with the tip
+    const CBlockIndex* pindexTip = chainActive.Tip();
+    if (pindexTip && pindexTip == pindexMaturity)
+        return mapMaturityHeight;
 
-    //Generate final map
     map<CoinDenomination, int> mapRet;
     for (auto denom : libzerocoin::zerocoinDenomList)
-        mapRet.insert(make_pair(denom, mapDenomMaturity.at(denom).second));
+        mapRet.insert(make_pair(denom, 0));
+
+    const int nStartHeight = Params().Zerocoin_StartHeight();
+    int nConfirmedHeight = chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations();
+    if (nConfirmedHeight > nStartHeight) {
+        // A mint need to get to at least the min maturity height before it will spend.
+        int nMinimumMaturityHeight = nConfirmedHeight - (nConfirmedHeight % 10);
+        SyncMintCounts(nConfirmedHeight);
+
+        // For each denomination find the highest block from which the blocks up to the confirmed height hold
+        // the required accumulation of mints, the running counts are sorted so a binary search finds it
+        int nRequired = Params().Zerocoin_RequiredAccumulation();
+        for (auto denom : libzerocoin::zerocoinDenomList) {
+            const std::vector<int>& vCounts = mapMintCounts.at(denom);
+            auto itConfirmed = vCounts.begin() + (nConfirmedHeight - nStartHeight);
+            int nTarget = *itConfirmed - nRequired;
+            if (nTarget < 0)
+                continue;
+
+            int nHeightMature = nStartHeight + (int)(std::upper_bound(vCounts.begin(), itConfirmed + 1, nTarget) - vCounts.begin());
+            mapRet.at(denom) = std::min(std::min(nHeightMature, nConfirmedHeight), nMinimumMaturityHeight);
+        }
+    }
 
+    pindexMaturity = pindexTip;
+    mapMaturityHeight = mapRet;
     return mapRet;
 }
@@ -17,11 +17,31 @@
 
 class CBlockIndex;
 
+/** The height a mint of each denomination has to be below to be spendable, recalculated once per tip */
 std::map<libzerocoin::CoinDenomination, int> GetMintMaturityHeight();
+/** Forget the mint counts and maturity heights, for when the block index entries they point at go away */
+void ResetMintMaturityCache();
 
 /**
- * Calculate the acc witness for a single coin.
- * @return true if the witness was calculated well
+ * A light wallet's part of a witness calculation. Coins matching its filter are
+ * left out of its witness and returned in listFilteredCoins.
+ */
+struct LightWitnessRequest
+{
+    CBloomFilter filter;
+    CBigNum bnWitnessValue;
+    //! The accumulator value answered with, the node's own value unless one is found on the chain
+    CBigNum bnAccumulatorValue;
+    std::list<CBigNum> listFilteredCoins;
+    int nMintsAdded;
+
+    LightWitnessRequest(const CBloomFilter& filter, const CBigNum& bnWitnessValue) : filter(filter), bnWitnessValue(bnWitnessValue), bnAccumulatorValue(bnWitnessValue), nMintsAdded(0) {}
+};
+
+/**
+ * Calculate the acc witnesses of requests that share a denomination and starting height
+ * in one pass over the chain.
+ * @return true if the witnesses were calculated well
  */
 
 bool CalculateAccumulatorWitnessFor(
@@ -29,12 +49,10 @@ bool CalculateAccumulatorWitnessFor(
         int startingHeight,
         int maxCalculationRange,
         libzerocoin::CoinDenomination den,
-        const CBloomFilter& filter,
+        std::vector<LightWitnessRequest>& vRequests,
         libzerocoin::Accumulator& accumulator,
-        libzerocoin::AccumulatorWitness& witness,
         int& nMintsAdded,
         string& strError,
-        list<CBigNum>& ret,
         int &heightStop
 );
 
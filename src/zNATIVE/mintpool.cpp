@@ -29,6 +29,7 @@ void CMintPool::Add(const CBigNum& bnValue, const uint32_t& nCount)
 void CMintPool::Add(const pair<uint256, uint32_t>& pMint, bool fVerbose)
 {
     insert(pMint);
+    mapCountHash[pMint.second] = pMint.first;
     if (pMint.second > nCountLastGenerated)
         nCountLastGenerated = pMint.second;
 
@@ -67,6 +68,7 @@ std::list<pair<uint256, uint32_t> > CMintPool::List()
 void CMintPool::Reset()
 {
     clear();
+    mapCountHash.clear();
     nCountLastGenerated = 0;
     nCountLastRemoved = 0;
 }
@@ -102,6 +104,9 @@ void CMintPool::Remove(const uint256& hashPubcoin)
         return;
 
     nCountLastRemoved = it->second;
+    auto itCount = mapCountHash.find(it->second);
+    if (itCount != mapCountHash.end() && itCount->second == hashPubcoin)
+        mapCountHash.erase(itCount);
     erase(it);
 }
 
@@ -25,6 +25,7 @@ class CMintPool : public std::map<uint256, uint32_t> //pubcoin hash, count
 private:
     uint32_t nCountLastGenerated;
     uint32_t nCountLastRemoved;
+    std::map<uint32_t, uint256> mapCountHash; //count, pubcoin hash
 
 public:
     CMintPool();
@@ -32,6 +33,7 @@ public:
     void Add(const CBigNum& bnValue, const uint32_t& nCount);
     void Add(const std::pair<uint256, uint32_t>& pMint, bool fVerbose = false);
     bool Has(const CBigNum& bnValue);
+    bool HasCount(uint32_t nCount) const { return mapCountHash.count(nCount) > 0; }
     void Remove(const CBigNum& bnValue);
     void Remove(const uint256& hashPubcoin);
     std::pair<uint256, uint32_t> Get(const CBigNum& bnValue);
@@ -0,0 +1,66 @@
+// Copyright (c) 2017-2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "zNATIVE/serialfilter.h"
+
+#include "random.h"
+
+#include <algorithm>
+#include <limits>
+
+// 10 bits and 7 hash functions per element give a false positive rate just under 1%
+static const size_t SERIAL_FILTER_BITS_PER_ELEMENT = 10;
+static const unsigned int SERIAL_FILTER_HASH_FUNCS = 7;
+
+// The serial hashes come from the chain, salt them so spends can not be crafted to fill the same bits
+static inline uint64_t MixSalted(uint64_t n, uint64_t nSalt)
+{
+    n ^= nSalt;
+    n = (n ^ (n >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    n = (n ^ (n >> 27)) * 0x94d049bb133111ebULL;
+    return n ^ (n >> 31);
+}
+
+CSerialFilter::CSerialFilter(size_t nCapacity) : nSalt(GetRand(std::numeric_limits<uint64_t>::max()))
+{
+    reset(nCapacity);
+}
+
+void CSerialFilter::reset(size_t nCapacityIn)
+{
+    nCapacity = std::max<size_t>(nCapacityIn, 1);
+    nElements = 0;
+    vData.assign((nCapacity * SERIAL_FILTER_BITS_PER_ELEMENT + 63) / 64, 0);
+}
+
+void CSerialFilter::GetIndexes(const uint256& hashSerial, uint64_t& nHash1, uint64_t& nHash2) const
+{
+    nHash1 = MixSalted(hashSerial.Get64(0) ^ hashSerial.Get64(2), nSalt);
+    nHash2 = MixSalted(hashSerial.Get64(1) ^ hashSerial.Get64(3), ~nSalt) | 1;
+}
+
+void CSerialFilter::insert(const uint256& hashSerial)
+{
+    uint64_t nHash1, nHash2;
+    GetIndexes(hashSerial, nHash1, nHash2);
+    const uint64_t nBits = vData.size() * 64;
+    for (unsigned int i = 0; i < SERIAL_FILTER_HASH_FUNCS; i++) {
+        uint64_t nBit = (nHash1 + i * nHash2) % nBits;
+        vData[nBit >> 6] |= (uint64_t)1 << (nBit & 63);
+    }
+    nElements++;
+}
+
+bool CSerialFilter::contains(const uint256& hashSerial) const
+{
+    uint64_t nHash1, nHash2;
+    GetIndexes(hashSerial, nHash1, nHash2);
+    const uint64_t nBits = vData.size() * 64;
+    for (unsigned int i = 0; i < SERIAL_FILTER_HASH_FUNCS; i++) {
+        uint64_t nBit = (nHash1 + i * nHash2) % nBits;
+        if (!(vData[nBit >> 6] & ((uint64_t)1 << (nBit & 63))))
+            return false;
+    }
+    return true;
+}
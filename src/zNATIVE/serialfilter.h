@@ -0,0 +1,46 @@
+// Copyright (c) 2017-2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef nativecoin_SERIALFILTER_H
+#define nativecoin_SERIALFILTER_H
+
+#include "uint256.h"
+
+#include <vector>
+
+/** Number of spent serials the filter is sized for before it has to grow */
+static const size_t DEFAULT_SERIAL_FILTER_CAPACITY = 1000000;
+
+/**
+ * Bloom filter over the hashes of the spent zerocoin serials, put in front of the
+ * serial lookups of the zerocoinDB. A serial that is not in the filter was never spent.
+ * Serials are never removed: a spend that is disconnected stays in as a false positive,
+ * which only costs the database read the filter would otherwise have saved.
+ */
+class CSerialFilter
+{
+private:
+    std::vector<uint64_t> vData;
+    uint64_t nSalt;
+    size_t nCapacity;
+    size_t nElements;
+
+    void GetIndexes(const uint256& hashSerial, uint64_t& nHash1, uint64_t& nHash2) const;
+
+public:
+    /** About 1% false positives while it holds no more than nCapacity serials */
+    explicit CSerialFilter(size_t nCapacity = DEFAULT_SERIAL_FILTER_CAPACITY);
+
+    void insert(const uint256& hashSerial);
+    bool contains(const uint256& hashSerial) const;
+    /** Drop all the serials and size the filter for nCapacity of them */
+    void reset(size_t nCapacity);
+
+    size_t size() const { return nElements; }
+    size_t capacity() const { return nCapacity; }
+    /** The false positive rate is getting above its target, the filter should be rebuilt larger */
+    bool IsFull() const { return nElements > nCapacity; }
+};
+
+#endif //nativecoin_SERIALFILTER_H
@@ -0,0 +1,88 @@
+// Copyright (c) 2017-2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "spendcache.h"
+
+#include "hash.h"
+#include "random.h"
+#include "uint256.h"
+#include "util.h"
+
+#include <boost/thread.hpp>
+
+namespace {
+
+/**
+ * Valid zerocoin spend cache, to avoid verifying the same spend proofs every time
+ * the spend is seen: when accepted into the memory pool, when its block is checked
+ * and again when it is the stake of a forked block.
+ */
+class CZerocoinSpendCache
+{
+private:
+    //! Random salt, so that peers can't predict the entries of our cache
+    uint256 nonce;
+    std::set<uint256> setValid;
+    boost::shared_mutex cs_spendcache;
+
+public:
+    CZerocoinSpendCache()
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    //! An entry is the salted hash of the whole spend, the accumulator it was verified against and the range check flag.
+    //! Neither serializes the V1 or V2 params it is read with, so the moduli of the params of the spend proofs and of the
+    //! accumulator are hashed too: the same bytes read with other params make another entry.
+    uint256 ComputeEntry(const libzerocoin::CoinSpend& spend, const libzerocoin::Accumulator& accumulator, bool fVerifyParams) const
+    {
+        CHashWriter ss(SER_GETHASH, 0);
+        ss << nonce << spend << spend.getSerialNumberProofParams()->accumulatorParams.accumulatorModulus
+           << spend.getAccumulatorProofParams()->accumulatorModulus << accumulator.getParams()->accumulatorModulus
+           << accumulator << fVerifyParams;
+        return ss.GetHash();
+    }
+
+    bool Get(const uint256& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_spendcache);
+        return setValid.count(entry);
+    }
+
+    void Set(const uint256& entry)
+    {
+        int64_t nMaxCacheSize = GetArg("-maxzcspendcachesize", DEFAULT_MAX_ZEROCOIN_SPEND_CACHE_SIZE);
+        if (nMaxCacheSize <= 0) return;
+
+        boost::unique_lock<boost::shared_mutex> lock(cs_spendcache);
+
+        while (static_cast<int64_t>(setValid.size()) >= nMaxCacheSize) {
+            // Evict a random entry, entries are salted hashes so no one can aim at a specific one
+            std::set<uint256>::iterator it = setValid.lower_bound(GetRandHash());
+            if (it == setValid.end())
+                it = setValid.begin();
+            setValid.erase(it);
+        }
+
+        setValid.insert(entry);
+    }
+};
+
+}
+
+bool VerifyZerocoinSpendCached(const libzerocoin::CoinSpend& spend, const libzerocoin::Accumulator& accumulator, bool fVerifyParams, bool fStore)
+{
+    static CZerocoinSpendCache spendCache;
+
+    uint256 entry = spendCache.ComputeEntry(spend, accumulator, fVerifyParams);
+    if (spendCache.Get(entry))
+        return true;
+
+    if (!spend.Verify(accumulator, fVerifyParams))
+        return false;
+
+    if (fStore)
+        spendCache.Set(entry);
+    return true;
+}
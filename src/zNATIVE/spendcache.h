@@ -0,0 +1,21 @@
+// Copyright (c) 2017-2019 The nativecoin developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef nativecoin_SPENDCACHE_H
+#define nativecoin_SPENDCACHE_H
+
+#include "libzerocoin/Accumulator.h"
+#include "libzerocoin/CoinSpend.h"
+
+/** Default for -maxzcspendcachesize, the number of validated zerocoin spends remembered */
+static const int64_t DEFAULT_MAX_ZEROCOIN_SPEND_CACHE_SIZE = 10000;
+
+/**
+ * Verify a zerocoin spend against an accumulator, skipping the proof verification when the
+ * same spend was already found valid against the same accumulator.
+ * Valid spends are remembered when fStore is set.
+ */
+bool VerifyZerocoinSpendCached(const libzerocoin::CoinSpend& spend, const libzerocoin::Accumulator& accumulator, bool fVerifyParams, bool fStore = true);
+
+#endif //nativecoin_SPENDCACHE_H
@@ -18,14 +18,14 @@ using namespace std;
 CzNATIVETracker::CzNATIVETracker(std::string strWalletFile)
 {
     this->strWalletFile = strWalletFile;
-    mapSerialHashes.clear();
+    Clear();
     mapPendingSpends.clear();
     fInitialized = false;
 }
 
 CzNATIVETracker::~CzNATIVETracker()
 {
-    mapSerialHashes.clear();
+    Clear();
     mapPendingSpends.clear();
 }
 
@@ -40,8 +40,11 @@ void CzNATIVETracker::Init()
 
 bool CzNATIVETracker::Archive(CMintMeta& meta)
 {
-    if (mapSerialHashes.count(meta.hashSerial))
-        mapSerialHashes.at(meta.hashSerial).isArchived = true;
+    if (mapSerialHashes.count(meta.hashSerial)) {
+        CMintMeta metaArchived = mapSerialHashes.at(meta.hashSerial);
+        metaArchived.isArchived = true;
+        SetMeta(metaArchived);
+    }
 
     CWalletDB walletdb(strWalletFile);
     CZerocoinMint mint;
@@ -90,25 +93,21 @@ CMintMeta CzNATIVETracker::Get(const uint256 &hashSerial)
 
 CMintMeta CzNATIVETracker::GetMetaFromPubcoin(const uint256& hashPubcoin)
 {
-    for (auto it : mapSerialHashes) {
-        CMintMeta meta = it.second;
-        if (meta.hashPubcoin == hashPubcoin)
-            return meta;
-    }
+    auto it = mapPubcoinHashes.find(hashPubcoin);
+    if (it == mapPubcoinHashes.end())
+        return CMintMeta();
 
-    return CMintMeta();
+    return mapSerialHashes.at(it->second);
 }
 
 bool CzNATIVETracker::GetMetaFromStakeHash(const uint256& hashStake, CMintMeta& meta) const
 {
-    for (auto& it : mapSerialHashes) {
-        if (it.second.hashStake == hashStake) {
-            meta = it.second;
-            return true;
-        }
-    }
+    auto it = mapStakeHashes.find(hashStake);
+    if (it == mapStakeHashes.end())
+        return false;
 
-    return false;
+    meta = mapSerialHashes.at(it->second);
+    return true;
 }
 
 CoinWitnessData* CzNATIVETracker::GetSpendCache(const uint256& hashStake)
@@ -160,18 +159,18 @@ CAmount CzNATIVETracker::GetBalance(bool fConfirmedOnly, bool fUnconfirmedOnly)
     {
         //LOCK(cs_N8Vtracker);
         // Get Unused coins
-        for (auto& it : mapSerialHashes) {
-            CMintMeta meta = it.second;
-            if (meta.isUsed || meta.isArchived)
-                continue;
-            bool fConfirmed = ((meta.nHeight < chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations()) && !(meta.nHeight == 0));
-            if (fConfirmedOnly && !fConfirmed)
-                continue;
-            if (fUnconfirmedOnly && fConfirmed)
-                continue;
-
-            nTotal += libzerocoin::ZerocoinDenominationToAmount(meta.denom);
-            myZerocoinSupply.at(meta.denom)++;
+        for (auto& denomMints : mapUnusedMints) {
+            for (auto& heightMint : denomMints.second) {
+                const CMintMeta& meta = mapSerialHashes.at(heightMint.second);
+                bool fConfirmed = ((meta.nHeight < chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations()) && !(meta.nHeight == 0));
+                if (fConfirmedOnly && !fConfirmed)
+                    continue;
+                if (fUnconfirmedOnly && fConfirmed)
+                    continue;
+
+                nTotal += libzerocoin::ZerocoinDenominationToAmount(meta.denom);
+                myZerocoinSupply.at(meta.denom)++;
+            }
         }
     }
 
@@ -188,14 +187,14 @@ CAmount CzNATIVETracker::GetUnconfirmedBalance() const
 std::vector<CMintMeta> CzNATIVETracker::GetMints(bool fConfirmedOnly) const
 {
     vector<CMintMeta> vMints;
-    for (auto& it : mapSerialHashes) {
-        CMintMeta mint = it.second;
-        if (mint.isArchived || mint.isUsed)
-            continue;
-        bool fConfirmed = (mint.nHeight < chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations());
-        if (fConfirmedOnly && !fConfirmed)
-            continue;
-        vMints.emplace_back(mint);
+    for (auto& denomMints : mapUnusedMints) {
+        for (auto& heightMint : denomMints.second) {
+            const CMintMeta& mint = mapSerialHashes.at(heightMint.second);
+            bool fConfirmed = (mint.nHeight < chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations());
+            if (fConfirmedOnly && !fConfirmed)
+                continue;
+            vMints.emplace_back(mint);
+        }
     }
     return vMints;
 }
@@ -220,12 +219,7 @@ bool CzNATIVETracker::HasPubcoin(const CBigNum &bnValue) const
 
 bool CzNATIVETracker::HasPubcoinHash(const uint256& hashPubcoin) const
 {
-    for (auto it : mapSerialHashes) {
-        CMintMeta meta = it.second;
-        if (meta.hashPubcoin == hashPubcoin)
-            return true;
-    }
-    return false;
+    return mapPubcoinHashes.count(hashPubcoin) > 0;
 }
 
 bool CzNATIVETracker::HasSerial(const CBigNum& bnSerial) const
@@ -252,7 +246,7 @@ bool CzNATIVETracker::UpdateZerocoinMint(const CZerocoinMint& mint)
     meta.isUsed = mint.IsUsed();
     meta.denom = mint.GetDenomination();
     meta.nHeight = mint.GetHeight();
-    mapSerialHashes.at(hashSerial) = meta;
+    SetMeta(meta);
 
     //Write to db
     return CWalletDB(strWalletFile).WriteZerocoinMint(mint);
@@ -296,7 +290,7 @@ bool CzNATIVETracker::UpdateState(const CMintMeta& meta)
             return error("%s: failed to write mint to database", __func__);
     }
 
-    mapSerialHashes[meta.hashSerial] = meta;
+    SetMeta(meta);
 
     return true;
 }
@@ -320,7 +314,7 @@ void CzNATIVETracker::Add(const CDeterministicMint& dMint, bool isNew, bool isAr
     meta.isSeedCorrect = zNATIVEWallet->CheckSeed(dMint);
     if (! iszNATIVEWalletInitialized)
         delete zNATIVEWallet;
-    mapSerialHashes[meta.hashSerial] = meta;
+    SetMeta(meta);
 
     if (isNew)
         CWalletDB(strWalletFile).WriteDeterministicMint(dMint);
@@ -341,12 +335,32 @@ void CzNATIVETracker::Add(const CZerocoinMint& mint, bool isNew, bool isArchived
     meta.isArchived = isArchived;
     meta.isDeterministic = false;
     meta.isSeedCorrect = true;
-    mapSerialHashes[meta.hashSerial] = meta;
+    SetMeta(meta);
 
     if (isNew)
         CWalletDB(strWalletFile).WriteZerocoinMint(mint);
 }
 
+void CzNATIVETracker::SetMeta(const CMintMeta& meta)
+{
+    // Drop the index entries of the previous state of the mint
+    auto it = mapSerialHashes.find(meta.hashSerial);
+    if (it != mapSerialHashes.end()) {
+        const CMintMeta& metaOld = it->second;
+        mapPubcoinHashes.erase(metaOld.hashPubcoin);
+        mapStakeHashes.erase(metaOld.hashStake);
+        if (mapUnusedMints.count(metaOld.denom))
+            mapUnusedMints.at(metaOld.denom).erase(make_pair(metaOld.nHeight, metaOld.hashSerial));
+    }
+
+    mapSerialHashes[meta.hashSerial] = meta;
+    mapPubcoinHashes[meta.hashPubcoin] = meta.hashSerial;
+    if (meta.hashStake != 0)
+        mapStakeHashes[meta.hashStake] = meta.hashSerial;
+    if (!meta.isUsed && !meta.isArchived)
+        mapUnusedMints[meta.denom].insert(make_pair(meta.nHeight, meta.hashSerial));
+}
+
 void CzNATIVETracker::SetPubcoinUsed(const uint256& hashPubcoin, const uint256& txid)
 {
     if (!HasPubcoinHash(hashPubcoin))
@@ -462,8 +476,8 @@ bool CzNATIVETracker::UpdateStatusInternal(const std::set<uint256>& setMempool,
 
 std::set<CMintMeta> CzNATIVETracker::ListMints(bool fUnusedOnly, bool fMatureOnly, bool fUpdateStatus, bool fWrongSeed)
 {
-    CWalletDB walletdb(strWalletFile);
     if (fUpdateStatus) {
+        CWalletDB walletdb(strWalletFile);
         std::list<CZerocoinMint> listMintsDB = walletdb.ListMintedCoins();
         for (auto& mint : listMintsDB)
             Add(mint);
@@ -477,58 +491,90 @@ std::set<CMintMeta> CzNATIVETracker::ListMints(bool fUnusedOnly, bool fMatureOnl
         }
         delete zNATIVEWallet;
         LogPrint("zero", "%s: added %d dzNATIVE from DB\n", __func__, listDeterministicDB.size());
-    }
 
-    std::vector<CMintMeta> vOverWrite;
-    std::set<CMintMeta> setMints;
-    std::set<uint256> setMempool;
-    {
-        LOCK(mempool.cs);
-        mempool.getTransactions(setMempool);
-    }
+        std::vector<CMintMeta> vOverWrite;
+        std::set<uint256> setMempool;
+        {
+            LOCK(mempool.cs);
+            mempool.getTransactions(setMempool);
+        }
 
-    std::map<libzerocoin::CoinDenomination, int> mapMaturity = GetMintMaturityHeight();
-    for (auto& it : mapSerialHashes) {
-        CMintMeta mint = it.second;
+        for (auto& it : mapSerialHashes) {
+            CMintMeta mint = it.second;
 
-        //This is only intended for unarchived coins
-        if (mint.isArchived)
-            continue;
+            //This is only intended for unarchived coins
+            if (mint.isArchived)
+                continue;
+
+            // Update the metadata of the mints, mints that were archived are already updated
+            if (UpdateStatusInternal(setMempool, mint) && !mint.isArchived)
+                vOverWrite.emplace_back(mint);
+        }
 
-        // Update the metadata of the mints if requested
-        if (fUpdateStatus && UpdateStatusInternal(setMempool, mint)) {
+        //overwrite any updates
+        for (CMintMeta& meta : vOverWrite)
+            UpdateState(meta);
+    }
+
+    std::map<libzerocoin::CoinDenomination, int> mapMaturity;
+    if (fMatureOnly)
+        mapMaturity = GetMintMaturityHeight();
+    int nConfirmedHeight = chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations();
+
+    std::set<CMintMeta> setMints;
+    if (!fUnusedOnly) {
+        for (auto& it : mapSerialHashes) {
+            const CMintMeta& mint = it.second;
             if (mint.isArchived)
                 continue;
 
-            // Mint was updated, queue for overwrite
-            vOverWrite.emplace_back(mint);
+            if (fMatureOnly) {
+                // Not confirmed
+                if (!mint.nHeight || mint.nHeight > nConfirmedHeight)
+                    continue;
+                if (mint.nHeight >= mapMaturity.at(mint.denom))
+                    continue;
+            }
+
+            if (!fWrongSeed && !mint.isSeedCorrect)
+                continue;
+
+            setMints.insert(mint);
         }
 
-        if (fUnusedOnly && mint.isUsed)
-            continue;
+        return setMints;
+    }
 
+    // The unused mints are indexed by height for each denomination, the mature ones are
+    // confirmed and below the maturity height of their denomination: a range of the index
+    for (auto& denomMints : mapUnusedMints) {
+        const std::set<std::pair<int, uint256> >& setDenomMints = denomMints.second;
+        auto itBegin = setDenomMints.begin();
+        auto itEnd = setDenomMints.end();
         if (fMatureOnly) {
-            // Not confirmed
-            if (!mint.nHeight || mint.nHeight > chainActive.Height() - Params().Zerocoin_MintRequiredConfirmations())
-                continue;
-            if (mint.nHeight >= mapMaturity.at(mint.denom))
+            int nHeightEnd = std::min(nConfirmedHeight + 1, mapMaturity.at(denomMints.first));
+            if (nHeightEnd <= 1)
                 continue;
+            itBegin = setDenomMints.lower_bound(make_pair(1, uint256()));
+            itEnd = setDenomMints.lower_bound(make_pair(nHeightEnd, uint256()));
         }
 
-        if (!fWrongSeed && !mint.isSeedCorrect)
-            continue;
+        for (auto it = itBegin; it != itEnd; ++it) {
+            const CMintMeta& mint = mapSerialHashes.at(it->second);
+            if (!fWrongSeed && !mint.isSeedCorrect)
+                continue;
 
-        setMints.insert(mint);
+            setMints.insert(mint);
+        }
     }
 
-    //overwrite any updates
-    for (CMintMeta& meta : vOverWrite)
-        UpdateState(meta);
-
     return setMints;
 }
 
 void CzNATIVETracker::Clear()
 {
     mapSerialHashes.clear();
+    mapPubcoinHashes.clear();
+    mapStakeHashes.clear();
+    mapUnusedMints.clear();
 }
@@ -21,6 +21,11 @@ private:
     std::map<uint256, CMintMeta> mapSerialHashes;
     std::map<uint256, uint256> mapPendingSpends; //serialhash, txid of spend
     std::map<uint256, std::unique_ptr<CoinWitnessData> > mapStakeCache; //serialhash, witness value, height
+    // Indexes of mapSerialHashes, only changed through SetMeta() and Clear()
+    std::map<uint256, uint256> mapPubcoinHashes; //pubcoinhash, serialhash
+    std::map<uint256, uint256> mapStakeHashes; //stakehash, serialhash
+    std::map<libzerocoin::CoinDenomination, std::set<std::pair<int, uint256> > > mapUnusedMints; //denom, (height, serialhash) of the unused and unarchived mints
+    void SetMeta(const CMintMeta& meta);
     bool UpdateStatusInternal(const std::set<uint256>& setMempool, CMintMeta& mint);
 public:
     CzNATIVETracker(std::string strWalletFile);
@@ -11,6 +11,10 @@
 #include "deterministicmint.h"
 #include "zNATIVEchain.h"
 
+#include <atomic>
+
+#include <boost/thread.hpp>
+
 using namespace libzerocoin;
 
 CzNATIVEWallet::CzNATIVEWallet(std::string strWalletFile)
@@ -104,12 +108,12 @@ void CzNATIVEWallet::AddToMintPool(const std::pair<uint256, uint32_t>& pMint, bo
 }
 
 //Add the next 20 mints to the mint pool
-void CzNATIVEWallet::GenerateMintPool(uint32_t nCountStart, uint32_t nCountEnd)
+bool CzNATIVEWallet::GenerateMintPool(uint32_t nCountStart, uint32_t nCountEnd)
 {
 
     //Is locked
     if (seedMaster == 0)
-        return;
+        return true;
 
     uint32_t n = nCountLastUsed + 1;
 
@@ -120,38 +124,62 @@ void CzNATIVEWallet::GenerateMintPool(uint32_t nCountStart, uint32_t nCountEnd)
     if (nCountEnd > 0)
         nStop = std::max(n, n + nCountEnd);
 
-    bool fFound;
-
     uint256 hashSeed = Hash(seedMaster.begin(), seedMaster.end());
     LogPrintf("%s : n=%d nStop=%d\n", __func__, n, nStop - 1);
-    for (uint32_t i = n; i < nStop; ++i) {
-        if (ShutdownRequested())
-            return;
 
-        fFound = false;
+    // Prevent unnecessary repeated minted
+    std::vector<uint32_t> vCounts;
+    for (uint32_t i = n; i < nStop; ++i) {
+        if (!mintPool.HasCount(i))
+            vCounts.emplace_back(i);
+    }
 
-        // Prevent unnecessary repeated minted
-        for (auto& pair : mintPool) {
-            if(pair.second == i) {
-                fFound = true;
-                break;
-            }
+    if (vCounts.empty())
+        return true;
+
+    // Searching for a prime pubcoin is the slow part, so spread the counts over the cores
+    std::vector<CBigNum> vValues(vCounts.size());
+    std::atomic<size_t> nNext(0);
+    auto generate = [&]() {
+        size_t j;
+        while ((j = nNext++) < vCounts.size() && !ShutdownRequested()) {
+            CBigNum bnSerial;
+            CBigNum bnRandomness;
+            CKey key;
+            SeedTozNATIVE(GetZerocoinSeed(vCounts[j]), vValues[j], bnSerial, bnRandomness, key);
         }
+    };
 
-        if(fFound)
-            continue;
+    size_t nThreads = std::min<size_t>(std::max(boost::thread::hardware_concurrency(), 1u), vCounts.size());
+    boost::thread_group threadGroup;
+    for (size_t t = 1; t < nThreads; t++)
+        threadGroup.create_thread(generate);
+    generate();
+    threadGroup.join_all();
 
-        uint512 seedZerocoin = GetZerocoinSeed(i);
-        CBigNum bnValue;
-        CBigNum bnSerial;
-        CBigNum bnRandomness;
-        CKey key;
-        SeedTozNATIVE(seedZerocoin, bnValue, bnSerial, bnRandomness, key);
+    if (ShutdownRequested())
+        return true;
 
-        mintPool.Add(bnValue, i);
-        CWalletDB(strWalletFile).WriteMintPoolPair(hashSeed, GetPubCoinHash(bnValue), i);
-        LogPrintf("%s : %s count=%d\n", __func__, bnValue.GetHex().substr(0, 6), i);
+    // Database the generated pairs in one transaction, the pool only gets them once they are stored
+    CWalletDB walletdb(strWalletFile);
+    if (!walletdb.TxnBegin())
+        return error("%s: failed to begin the mint pool transaction", __func__);
+    for (size_t j = 0; j < vCounts.size(); j++) {
+        if (!walletdb.WriteMintPoolPair(hashSeed, GetPubCoinHash(vValues[j]), vCounts[j])) {
+            walletdb.TxnAbort();
+            return error("%s: failed to write mint pool pair count=%d", __func__, vCounts[j]);
+        }
     }
+    if (!walletdb.TxnCommit()) {
+        walletdb.TxnAbort();
+        return error("%s: failed to commit the mint pool transaction", __func__);
+    }
+
+    for (size_t j = 0; j < vCounts.size(); j++) {
+        mintPool.Add(vValues[j], vCounts[j]);
+        LogPrintf("%s : %s count=%d\n", __func__, vValues[j].GetHex().substr(0, 6), vCounts[j]);
+    }
+    return true;
 }
 
 // pubcoin hashes are stored to db so that a full accounting of mints belonging to the seed can be tracked without regenerating
@@ -188,8 +216,11 @@ void CzNATIVEWallet::SyncWithChain(bool fGenerateMintPool)
     set<uint256> setAddedTx;
     while (found) {
         found = false;
-        if (fGenerateMintPool)
-            GenerateMintPool();
+        if (fGenerateMintPool && !GenerateMintPool()) {
+            // The pool was not stored, syncing against it would track mints the wallet cannot find again
+            LogPrintf("%s: failed to generate the mint pool, stopping the sync\n", __func__);
+            return;
+        }
         LogPrintf("%s: Mintpool size=%d\n", __func__, mintPool.size());
 
         std::set<uint256> setChecked;
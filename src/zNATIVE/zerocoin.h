@@ -11,6 +11,7 @@
 #include "libzerocoin/bignum.h"
 #include "libzerocoin/Denominations.h"
 #include "key.h"
+#include "primitives/transaction.h"
 #include "serialize.h"
 
 //struct that is safe to store essential mint data, without holding any information that allows for actual spending (serial, randomness, private key)
@@ -31,6 +32,50 @@ struct CMintMeta
     bool operator <(const CMintMeta& a) const;
 };
 
+//a mint as kept in the zerocoinDB index of the pubcoins of each block
+struct CBlockPubcoin
+{
+    libzerocoin::CoinDenomination denom;
+    CBigNum bnValue;
+    bool fValidOutPoint; //false if the mint is filtered out for using invalid outpoints
+
+    CBlockPubcoin() : denom(libzerocoin::ZQ_ERROR), fValidOutPoint(true) {}
+    CBlockPubcoin(libzerocoin::CoinDenomination denom, const CBigNum& bnValue, bool fValidOutPoint) :
+        denom(denom), bnValue(bnValue), fValidOutPoint(fValidOutPoint) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(denom);
+        READWRITE(bnValue);
+        READWRITE(fValidOutPoint);
+    };
+};
+
+//a coin spend as kept in the zerocoinDB index of the serials spent in each block
+struct CBlockSerial
+{
+    CBigNum bnSerial;
+    libzerocoin::CoinDenomination denom;
+    uint256 txid;
+    CTxOut txoutSpentTo; //first output of the spending transaction
+
+    CBlockSerial() : denom(libzerocoin::ZQ_ERROR) {}
+    CBlockSerial(const CBigNum& bnSerial, libzerocoin::CoinDenomination denom, const uint256& txid, const CTxOut& txoutSpentTo) :
+        bnSerial(bnSerial), denom(denom), txid(txid), txoutSpentTo(txoutSpentTo) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(bnSerial);
+        READWRITE(denom);
+        READWRITE(txid);
+        READWRITE(txoutSpentTo);
+    };
+};
+
 uint256 GetSerialHash(const CBigNum& bnSerial);
 uint256 GetPubCoinHash(const CBigNum& bnValue);
 
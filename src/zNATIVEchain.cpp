@@ -8,6 +8,10 @@
 #include "txdb.h"
 #include "ui_interface.h"
 
+#include <atomic>
+
+#include <boost/thread.hpp>
+
 // 6 comes from OPCODE (1) + vch.size() (1) + BIGNUM size (4)
 #define SCRIPT_OFFSET 6
 // For Script size (BIGNUM/Uint256 size)
@@ -79,6 +83,121 @@ bool BlockToPubcoinList(const CBlock& block, std::list<libzerocoin::PublicCoin>&
     return true;
 }
 
+//return the pubcoins of a block as recorded in the zerocoinDB index, keeping the ones that use invalid outpoints flagged
+bool BlockToPubcoinIndex(const CBlock& block, std::vector<CBlockPubcoin>& vPubcoins)
+{
+    for (const CTransaction& tx : block.vtx) {
+        if(!tx.IsZerocoinMint())
+            continue;
+
+        // Same filter as BlockToPubcoinList()
+        bool fValid = true;
+        for (const CTxIn& in : tx.vin) {
+            if (!ValidOutPoint(in.prevout, INT_MAX)) {
+                fValid = false;
+                break;
+            }
+        }
+
+        uint256 txHash = tx.GetHash();
+        for (unsigned int i = 0; i < tx.vout.size(); i++) {
+            //edge case: invalid spend with minted change, this and the following outputs are filtered
+            if (fValid && !ValidOutPoint(COutPoint(txHash, i), INT_MAX))
+                fValid = false;
+
+            const CTxOut txOut = tx.vout[i];
+            if(!txOut.scriptPubKey.IsZerocoinMint())
+                continue;
+
+            CValidationState state;
+            libzerocoin::PublicCoin pubCoin(Params().Zerocoin_Params(false));
+            if(!TxOutToPublicCoin(txOut, pubCoin, state))
+                return false;
+
+            vPubcoins.emplace_back(pubCoin.getDenomination(), pubCoin.getValue(), fValid);
+        }
+    }
+
+    return true;
+}
+
+//return the pubcoins of a block from the zerocoinDB index, reading the block for ones connected before the index existed
+bool GetBlockPubcoinList(const CBlockIndex* pindex, std::list<libzerocoin::PublicCoin>& listPubcoins, bool fFilterInvalid)
+{
+    std::vector<CBlockPubcoin> vPubcoins;
+    if (!zerocoinDB->ReadBlockPubcoins(pindex->GetBlockHash(), vPubcoins)) {
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex))
+            return error("%s: failed to read block %d from disk", __func__, pindex->nHeight);
+        return BlockToPubcoinList(block, listPubcoins, fFilterInvalid);
+    }
+
+    for (const CBlockPubcoin& mint : vPubcoins) {
+        if (fFilterInvalid && !mint.fValidOutPoint)
+            continue;
+        listPubcoins.emplace_back(libzerocoin::PublicCoin(Params().Zerocoin_Params(false), mint.bnValue, mint.denom));
+    }
+
+    return true;
+}
+
+//return the zerocoin spends of a block in the form they are kept in the zerocoinDB index
+bool BlockToSerialIndex(const CBlock& block, std::vector<CBlockSerial>& vSerials)
+{
+    for (const CTransaction& tx : block.vtx) {
+        if (!tx.IsZerocoinSpend())
+            continue;
+
+        uint256 txid = tx.GetHash();
+        for (const CTxIn& txin : tx.vin) {
+            if (!txin.scriptSig.IsZerocoinSpend())
+                continue;
+
+            libzerocoin::CoinSpend spend = TxInToZerocoinSpend(txin);
+            vSerials.emplace_back(spend.getCoinSerialNumber(), spend.getDenomination(), txid, tx.vout[0]);
+        }
+    }
+
+    return true;
+}
+
+//return the spends of a block from the zerocoinDB index, reading the block for ones connected before the index existed
+bool GetBlockSerialList(const CBlockIndex* pindex, std::vector<CBlockSerial>& vSerials)
+{
+    if (zerocoinDB->ReadBlockSerials(pindex->GetBlockHash(), vSerials))
+        return true;
+
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex))
+        return error("%s: failed to read block %d from disk", __func__, pindex->nHeight);
+    return BlockToSerialIndex(block, vSerials);
+}
+
+//GetBlockSerialList() of many blocks at once, the blocks are read by a thread per core
+bool GetBlockSerialLists(const std::vector<const CBlockIndex*>& vBlocks, std::vector<std::vector<CBlockSerial> >& vBlockSerials)
+{
+    vBlockSerials.assign(vBlocks.size(), std::vector<CBlockSerial>());
+
+    std::atomic<size_t> nNext(0);
+    std::atomic<bool> fFailed(false);
+    auto read = [&]() {
+        size_t i;
+        while ((i = nNext++) < vBlocks.size() && !fFailed) {
+            if (!GetBlockSerialList(vBlocks[i], vBlockSerials[i]))
+                fFailed = true;
+        }
+    };
+
+    size_t nThreads = std::min<size_t>(std::max(boost::thread::hardware_concurrency(), 1u), vBlocks.size());
+    boost::thread_group threadGroup;
+    for (size_t t = 1; t < nThreads; t++)
+        threadGroup.create_thread(read);
+    read();
+    threadGroup.join_all();
+
+    return !fFailed;
+}
+
 //return a list of zerocoin mints contained in a specific block
 bool BlockToZerocoinMintList(const CBlock& block, std::list<CZerocoinMint>& vMints, bool fFilterInvalid)
 {
@@ -253,76 +372,154 @@ bool IsSerialInBlockchain(const uint256& hashSerial, int& nHeightTx, uint256& tx
     return IsTransactionInChain(txidSpend, nHeightTx, tx);
 }
 
-std::string ReindexZerocoinDB()
+/** A block of the zerocoin reindex, read and parsed by the reader threads */
+struct CZerocoinReindexBlock
 {
-    if (!zerocoinDB->WipeCoins("spends") || !zerocoinDB->WipeCoins("mints")) {
-        return _("Failed to wipe zerocoinDB");
-    }
-
-    uiInterface.ShowProgress(_("Reindexing zerocoin database..."), 0);
-
-    CBlockIndex* pindex = chainActive[Params().Zerocoin_StartHeight()];
     std::vector<std::pair<libzerocoin::CoinSpend, uint256> > vSpendInfo;
     std::vector<std::pair<libzerocoin::PublicCoin, uint256> > vMintInfo;
-    while (pindex) {
-        uiInterface.ShowProgress(_("Reindexing zerocoin database..."), std::max(1, std::min(99, (int)((double)(pindex->nHeight - Params().Zerocoin_StartHeight()) / (double)(chainActive.Height() - Params().Zerocoin_StartHeight()) * 100))));
+    std::vector<CBlockPubcoin> vPubcoins;
+    std::vector<CBlockSerial> vSerials;
+};
 
-        if (pindex->nHeight % 1000 == 0)
-            LogPrintf("Reindexing zerocoin : block %d...\n", pindex->nHeight);
+static bool ReadZerocoinReindexBlock(const CBlockIndex* pindex, CZerocoinReindexBlock& reindexBlock)
+{
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex))
+        return error("%s: failed to read block %d from disk", __func__, pindex->nHeight);
 
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pindex)) {
-            return _("Reindexing zerocoin failed");
+    if (!BlockToPubcoinIndex(block, reindexBlock.vPubcoins) || !BlockToSerialIndex(block, reindexBlock.vSerials))
+        return error("%s: failed to index the zerocoins of block %d", __func__, pindex->nHeight);
+
+    for (const CTransaction& tx : block.vtx) {
+        if (tx.IsCoinBase() || !tx.ContainsZerocoins())
+            continue;
+
+        uint256 txid = tx.GetHash();
+        //Record Serials
+        if (tx.IsZerocoinSpend()) {
+            for (auto& in : tx.vin) {
+                if (!in.scriptSig.IsZerocoinSpend())
+                    continue;
+
+                libzerocoin::CoinSpend spend = TxInToZerocoinSpend(in);
+                reindexBlock.vSpendInfo.push_back(make_pair(spend, txid));
+            }
         }
 
-        for (const CTransaction& tx : block.vtx) {
-            for (unsigned int i = 0; i < tx.vin.size(); i++) {
-                if (tx.IsCoinBase())
-                    break;
+        //Record mints
+        if (tx.IsZerocoinMint()) {
+            for (auto& out : tx.vout) {
+                if (!out.IsZerocoinMint())
+                    continue;
 
-                if (tx.ContainsZerocoins()) {
-                    uint256 txid = tx.GetHash();
-                    //Record Serials
-                    if (tx.IsZerocoinSpend()) {
-                        for (auto& in : tx.vin) {
-                            if (!in.scriptSig.IsZerocoinSpend())
-                                continue;
-
-                            libzerocoin::CoinSpend spend = TxInToZerocoinSpend(in);
-                            vSpendInfo.push_back(make_pair(spend, txid));
-                        }
-                    }
-
-                    //Record mints
-                    if (tx.IsZerocoinMint()) {
-                        for (auto& out : tx.vout) {
-                            if (!out.IsZerocoinMint())
-                                continue;
-
-                            CValidationState state;
-                            libzerocoin::PublicCoin coin(Params().Zerocoin_Params(pindex->nHeight < Params().Zerocoin_Block_V2_Start()));
-                            TxOutToPublicCoin(out, coin, state);
-                            vMintInfo.push_back(make_pair(coin, txid));
-                        }
-                    }
-                }
+                CValidationState state;
+                libzerocoin::PublicCoin coin(Params().Zerocoin_Params(pindex->nHeight < Params().Zerocoin_Block_V2_Start()));
+                TxOutToPublicCoin(out, coin, state);
+                reindexBlock.vMintInfo.push_back(make_pair(coin, txid));
             }
         }
+    }
 
-        // Flush the zerocoinDB to disk every 100 blocks
-        if (pindex->nHeight % 100 == 0) {
-            if ((!vSpendInfo.empty() && !zerocoinDB->WriteCoinSpendBatch(vSpendInfo)) || (!vMintInfo.empty() && !zerocoinDB->WriteCoinMintBatch(vMintInfo)))
-                return _("Error writing zerocoinDB to disk");
-            vSpendInfo.clear();
-            vMintInfo.clear();
+    return true;
+}
+
+//ReadZerocoinReindexBlock() of a range of blocks, on a thread per core
+static void ReadZerocoinReindexBlocks(const std::vector<const CBlockIndex*>& vBlocks, std::vector<CZerocoinReindexBlock>& vReindexBlocks, std::atomic<bool>& fFailed)
+{
+    vReindexBlocks.assign(vBlocks.size(), CZerocoinReindexBlock());
+
+    std::atomic<size_t> nNext(0);
+    auto read = [&]() {
+        size_t i;
+        while ((i = nNext++) < vBlocks.size() && !fFailed) {
+            if (!ReadZerocoinReindexBlock(vBlocks[i], vReindexBlocks[i]))
+                fFailed = true;
         }
+    };
+
+    size_t nThreads = std::min<size_t>(std::max(boost::thread::hardware_concurrency(), 1u), vBlocks.size());
+    boost::thread_group threadGroup;
+    for (size_t t = 0; t < nThreads; t++)
+        threadGroup.create_thread(read);
+    threadGroup.join_all();
+}
 
-        pindex = chainActive.Next(pindex);
+std::string ReindexZerocoinDB()
+{
+    const int nZerocoinStartHeight = Params().Zerocoin_StartHeight();
+    const int nEndHeight = chainActive.Height();
+
+    // Continue an interrupted reindex from the last flushed block if it is still in the chain
+    int nFlushedHeight;
+    uint256 hashFlushed;
+    if (!zerocoinDB->ReadReindexProgress(nFlushedHeight, hashFlushed) || nFlushedHeight < nZerocoinStartHeight ||
+            nFlushedHeight > nEndHeight || chainActive[nFlushedHeight]->GetBlockHash() != hashFlushed) {
+        nFlushedHeight = nZerocoinStartHeight - 1;
+        if (!zerocoinDB->WriteReindexProgress(nFlushedHeight, nFlushedHeight >= 0 ? chainActive[nFlushedHeight]->GetBlockHash() : uint256()))
+            return _("Error writing zerocoinDB to disk");
+        if (!zerocoinDB->WipeCoins("spends") || !zerocoinDB->WipeCoins("mints")) {
+            return _("Failed to wipe zerocoinDB");
+        }
+    } else {
+        LogPrintf("Reindexing zerocoin : resuming after block %d\n", nFlushedHeight);
+    }
+
+    uiInterface.ShowProgress(_("Reindexing zerocoin database..."), 0);
+
+    // Derive the zerocoin parameters before the reader threads share them
+    Params().Zerocoin_Params(false);
+
+    // The blocks are read and parsed one range ahead of the writer, which flushes each range in a batch
+    std::vector<const CBlockIndex*> vBlocks, vBlocksNext;
+    std::vector<CZerocoinReindexBlock> vReindexBlocks, vReindexBlocksNext;
+    std::atomic<bool> fFailed(false);
+    auto GetRange = [&](int nHeight, std::vector<const CBlockIndex*>& vRange) {
+        vRange.clear();
+        for (; nHeight <= nEndHeight && vRange.size() < ZEROCOIN_REINDEX_BATCH_SIZE; nHeight++)
+            vRange.emplace_back(chainActive[nHeight]);
+    };
+
+    GetRange(nFlushedHeight + 1, vBlocks);
+    ReadZerocoinReindexBlocks(vBlocks, vReindexBlocks, fFailed);
+    int64_t nTimeStart = GetTimeMillis();
+    int nBlocksDone = 0;
+    while (!vBlocks.empty()) {
+        if (fFailed)
+            return _("Reindexing zerocoin failed");
+
+        GetRange(vBlocks.back()->nHeight + 1, vBlocksNext);
+        boost::thread threadNext(ReadZerocoinReindexBlocks, boost::cref(vBlocksNext), boost::ref(vReindexBlocksNext), boost::ref(fFailed));
+
+        std::vector<std::pair<libzerocoin::CoinSpend, uint256> > vSpendInfo;
+        std::vector<std::pair<libzerocoin::PublicCoin, uint256> > vMintInfo;
+        bool fWriteFailed = false;
+        for (size_t i = 0; i < vBlocks.size() && !fWriteFailed; i++) {
+            CZerocoinReindexBlock& reindexBlock = vReindexBlocks[i];
+            vSpendInfo.insert(vSpendInfo.end(), reindexBlock.vSpendInfo.begin(), reindexBlock.vSpendInfo.end());
+            vMintInfo.insert(vMintInfo.end(), reindexBlock.vMintInfo.begin(), reindexBlock.vMintInfo.end());
+            fWriteFailed = !zerocoinDB->WriteBlockPubcoins(vBlocks[i]->GetBlockHash(), reindexBlock.vPubcoins) ||
+                           !zerocoinDB->WriteBlockSerials(vBlocks[i]->GetBlockHash(), reindexBlock.vSerials);
+        }
+        fWriteFailed = fWriteFailed || (!vSpendInfo.empty() && !zerocoinDB->WriteCoinSpendBatch(vSpendInfo)) ||
+                       (!vMintInfo.empty() && !zerocoinDB->WriteCoinMintBatch(vMintInfo)) ||
+                       !zerocoinDB->WriteReindexProgress(vBlocks.back()->nHeight, vBlocks.back()->GetBlockHash());
+        if (fWriteFailed) {
+            fFailed = true;
+            threadNext.join();
+            return _("Error writing zerocoinDB to disk");
+        }
+
+        nBlocksDone += vBlocks.size();
+        int nHeight = vBlocks.back()->nHeight;
+        uiInterface.ShowProgress(_("Reindexing zerocoin database..."), std::max(1, std::min(99, (int)((double)(nHeight - nZerocoinStartHeight) / (double)(nEndHeight - nZerocoinStartHeight) * 100))));
+        LogPrintf("Reindexing zerocoin : block %d of %d, %.2f blocks/s\n", nHeight, nEndHeight, 1000.0 * nBlocksDone / std::max<int64_t>(GetTimeMillis() - nTimeStart, 1));
+
+        threadNext.join();
+        vBlocks.swap(vBlocksNext);
+        vReindexBlocks.swap(vReindexBlocksNext);
     }
-    uiInterface.ShowProgress("", 100);
 
-    // Final flush to disk in case any remaining information exists
-    if ((!vSpendInfo.empty() && !zerocoinDB->WriteCoinSpendBatch(vSpendInfo)) || (!vMintInfo.empty() && !zerocoinDB->WriteCoinMintBatch(vMintInfo)))
+    if (!zerocoinDB->EraseReindexProgress())
         return _("Error writing zerocoinDB to disk");
 
     uiInterface.ShowProgress("", 100);
@@ -12,6 +12,9 @@
 #include <string>
 
 class CBlock;
+class CBlockIndex;
+struct CBlockPubcoin;
+struct CBlockSerial;
 class CBigNum;
 struct CMintMeta;
 class CTransaction;
@@ -23,6 +26,11 @@ class uint256;
 
 bool BlockToMintValueVector(const CBlock& block, const libzerocoin::CoinDenomination denom, std::vector<CBigNum>& vValues);
 bool BlockToPubcoinList(const CBlock& block, std::list<libzerocoin::PublicCoin>& listPubcoins, bool fFilterInvalid);
+bool BlockToPubcoinIndex(const CBlock& block, std::vector<CBlockPubcoin>& vPubcoins);
+bool GetBlockPubcoinList(const CBlockIndex* pindex, std::list<libzerocoin::PublicCoin>& listPubcoins, bool fFilterInvalid);
+bool BlockToSerialIndex(const CBlock& block, std::vector<CBlockSerial>& vSerials);
+bool GetBlockSerialList(const CBlockIndex* pindex, std::vector<CBlockSerial>& vSerials);
+bool GetBlockSerialLists(const std::vector<const CBlockIndex*>& vBlocks, std::vector<std::vector<CBlockSerial> >& vBlockSerials);
 bool BlockToZerocoinMintList(const CBlock& block, std::list<CZerocoinMint>& vMints, bool fFilterInvalid);
 void FindMints(std::vector<CMintMeta> vMintsToFind, std::vector<CMintMeta>& vMintsToUpdate, std::vector<CMintMeta>& vMissingMints);
 int GetZerocoinStartHeight();
@@ -33,6 +41,9 @@ bool IsSerialInBlockchain(const CBigNum& bnSerial, int& nHeightTx);
 bool IsSerialInBlockchain(const uint256& hashSerial, int& nHeightTx, uint256& txidSpend);
 bool IsSerialInBlockchain(const uint256& hashSerial, int& nHeightTx, uint256& txidSpend, CTransaction& tx);
 bool RemoveSerialFromDB(const CBigNum& bnSerial);
+/** Number of blocks ReindexZerocoinDB() reads ahead and flushes at once */
+static const size_t ZEROCOIN_REINDEX_BATCH_SIZE = 500;
+
 std::string ReindexZerocoinDB();
 libzerocoin::CoinSpend TxInToZerocoinSpend(const CTxIn& txin);
 bool TxOutToPublicCoin(const CTxOut& txout, libzerocoin::PublicCoin& pubCoin, CValidationState& state);